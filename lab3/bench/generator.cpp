@@ -0,0 +1,131 @@
+#include "generator.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+std::vector<bench::family> const& bench::all_families() {
+    static std::vector<family> const families = {
+        family::RANDOM,
+        family::GRID,
+        family::TREE,
+        family::POWER_LAW,
+        family::PATH,
+    };
+
+    return families;
+}
+
+bench::family bench::parse_family(std::string const& name) {
+    for (auto f : all_families()) {
+        if (name == family_name(f)) {
+            return f;
+        }
+    }
+
+    throw std::runtime_error("unknown graph family '" + name + "'");
+}
+
+char const* bench::family_name(family f) noexcept {
+    switch (f) {
+    case family::RANDOM:
+        return "random";
+    case family::GRID:
+        return "grid";
+    case family::TREE:
+        return "tree";
+    case family::POWER_LAW:
+        return "power-law";
+    case family::PATH:
+        return "path";
+    }
+
+    return "unknown";
+}
+
+graph::edge_list bench::generate(family f, size_t vertices_count, size_t degree, std::uint64_t seed) {
+    using std::vector;
+    using graph::vertex;
+
+    std::mt19937_64 random(seed);
+    auto uniform = [&](size_t bound) -> vertex {
+        return vertex(std::uniform_int_distribution<size_t>(0, bound - 1)(random));
+    };
+
+    graph::edge_list result;
+    auto& edges = result.edges;
+
+    switch (f) {
+    case family::RANDOM: {
+        size_t const m = vertices_count * degree / 2;
+        edges.reserve(m);
+        for (size_t i = 0; i < m; ++i) {
+            edges.push_back({ uniform(vertices_count), uniform(vertices_count) });
+        }
+        break;
+    }
+    case family::GRID: {
+        size_t const side = std::max<size_t>(2, size_t(std::sqrt(double(vertices_count))));
+        vertices_count = side * side;
+        edges.reserve(2 * vertices_count);
+        for (size_t row = 0; row < side; ++row) {
+            for (size_t column = 0; column < side; ++column) {
+                vertex const v = vertex(row * side + column);
+                if (column + 1 < side) {
+                    edges.push_back({ v, v + 1 });
+                }
+                if (row + 1 < side) {
+                    edges.push_back({ v, vertex(v + side) });
+                }
+            }
+        }
+        break;
+    }
+    case family::TREE:
+        edges.reserve(vertices_count - 1);
+        for (size_t v = 1; v < vertices_count; ++v) {
+            edges.push_back({ vertex(v), uniform(v) });
+        }
+        break;
+    case family::POWER_LAW: {
+        //! Preferential attachment
+        /** Endpoints of all edges so far; a uniform pick from it is proportional to degree. */
+        size_t const  per_vertex = std::max<size_t>(1, degree / 2);
+        vector<vertex> endpoints = { 0, 1 };
+        edges.reserve(vertices_count * per_vertex);
+        edges.push_back({ 0, 1 });
+        for (size_t v = 2; v < vertices_count; ++v) {
+            for (size_t i = 0; i < per_vertex; ++i) {
+                vertex const target = endpoints[uniform(endpoints.size())];
+                edges.push_back({ vertex(v), target });
+                endpoints.push_back(vertex(v));
+                endpoints.push_back(target);
+            }
+        }
+        break;
+    }
+    case family::PATH:
+        edges.reserve(vertices_count);
+        for (size_t v = 0; v + 1 < vertices_count; ++v) {
+            edges.push_back({ vertex(v), vertex(v + 1) });
+        }
+        edges.push_back({ vertex(vertices_count - 1), 0 });
+        break;
+    }
+
+    //! Shuffle ids and edge order
+    vector<vertex> labels(vertices_count);
+    std::iota(labels.begin(), labels.end(), vertex(0));
+    std::shuffle(labels.begin(), labels.end(), random);
+    for (auto& e : edges) {
+        e = { labels[e.u], labels[e.v] };
+    }
+    std::shuffle(edges.begin(), edges.end(), random);
+
+    result.vertices_count = vertices_count;
+
+    return result;
+}
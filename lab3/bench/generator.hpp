@@ -0,0 +1,31 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graph/loader.hpp"
+
+namespace bench {
+    //! Families of synthetic graphs
+    enum class family {
+        RANDOM,     ///< G(n, m) with m = n * degree / 2 uniform edges
+        GRID,       ///< square lattice, has cycles
+        TREE,       ///< random recursive tree, acyclic
+        POWER_LAW,  ///< preferential attachment, degree / 2 edges per new vertex
+        PATH,       ///< long path with one back-edge from its end to its start
+    };
+
+    //! All families in report order
+    std::vector<family> const& all_families();
+
+    family      parse_family(std::string const& name);
+    char const* family_name(family f) noexcept;
+
+    //! generate
+    /** Builds an edge list of about `vertices_count` vertices; grid is rounded down to a square.
+        Vertex ids are shuffled so no family has an unnaturally cache friendly layout. */
+    graph::edge_list generate(family f, size_t vertices_count, size_t degree, std::uint64_t seed);
+}
@@ -0,0 +1,238 @@
+/* stdlib: */
+#include <cstdlib>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "generator.hpp"
+#include "perf_counter.hpp"
+#include "graph/csr.hpp"
+#include "graph/reorder.hpp"
+#include "engines/engines.hpp"
+#include "runtime/thread_pool.hpp"
+
+//! Benchmark options
+struct options {
+    std::vector<bench::family>        families = bench::all_families();
+    std::vector<engines::engine_type> engines  = {
+        engines::engine_type::BFS,
+        engines::engine_type::UNION_FIND,
+        engines::engine_type::FRONTIER,
+        engines::engine_type::HYBRID,
+        engines::engine_type::SEQUENTIAL,
+        engines::engine_type::AUTO,
+    };
+    std::vector<graph::ordering>      orders   = { graph::ordering::NONE };
+    size_t        vertices = 1000000;
+    size_t        degree   = 8;
+    size_t        threads  = std::max(1u, std::thread::hardware_concurrency());
+    size_t        repeat   = 3;
+    std::uint64_t seed     = 1;
+    runtime::placement affinity = runtime::placement::NONE;
+};
+
+static size_t parse_number(char const* argument) {
+    using std::stringstream;
+    using std::runtime_error;
+
+    size_t value;
+    stringstream stream(argument);
+    stream >> value;
+    if (stream.fail() || value == 0) {
+        throw runtime_error(std::string("incorrect number '") + argument + "'");
+    }
+
+    return value;
+}
+
+//! parse
+/** Usage: Bench [--family name|all] [--engine name|all] [--vertices N] [--degree D]
+                 [--threads N] [--repeat R] [--seed S] [--affinity none|compact|spread]
+                 [--reorder none|degree|rcm|all]
+    Every engine runs with 1..N threads on every family and vertex order; best of R runs
+    is reported with cache misses of that run where hardware counters are available.
+    Throughput is shown only for runs that traversed the whole graph. */
+static void parse(int argc, char* argv[], options* opts) {
+    using std::string;
+    using std::runtime_error;
+
+    for (int i = 1; i < argc; ++i) {
+        string const argument = argv[i];
+        if (i + 1 == argc) {
+            throw runtime_error("value expected after '" + argument + "'");
+        }
+        char const* value = argv[++i];
+
+        if (argument == "--family") {
+            opts->families = string(value) == "all" ? bench::all_families()
+                                                    : std::vector<bench::family>{ bench::parse_family(value) };
+        } else if (argument == "--engine") {
+            if (string(value) != "all") {
+                opts->engines = { engines::parse_engine(value) };
+            }
+        } else if (argument == "--reorder") {
+            opts->orders = string(value) == "all"
+                ? std::vector<graph::ordering>{ graph::ordering::NONE, graph::ordering::DEGREE, graph::ordering::RCM }
+                : std::vector<graph::ordering>{ graph::parse_ordering(value) };
+        } else if (argument == "--vertices") {
+            opts->vertices = std::max<size_t>(2, parse_number(value));
+        } else if (argument == "--degree") {
+            opts->degree = parse_number(value);
+        } else if (argument == "--threads") {
+            opts->threads = parse_number(value);
+        } else if (argument == "--repeat") {
+            opts->repeat = parse_number(value);
+        } else if (argument == "--seed") {
+            opts->seed = parse_number(value);
+        } else if (argument == "--affinity") {
+            opts->affinity = runtime::parse_placement(value);
+        } else {
+            throw runtime_error("unknown argument '" + argument + "'");
+        }
+    }
+}
+
+//! peak rss
+/** Returns peak resident set size of the process in megabytes. */
+static double peak_rss_megabytes() noexcept {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return double(counters.PeakWorkingSetSize) / (1024 * 1024);
+#else
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return double(usage.ru_maxrss) / (1024 * 1024);
+#else
+    return double(usage.ru_maxrss) / 1024;
+#endif
+#endif
+}
+
+template<typename callable>
+static double measure(callable&& callback) {
+    using clock = std::chrono::steady_clock;
+
+    auto const begin = clock::now();
+    callback();
+    return std::chrono::duration<double>(clock::now() - begin).count();
+}
+
+int main(int argc, char* argv[]) try {
+    using std::cout;
+    using std::endl;
+    using std::setw;
+    using std::fixed;
+    using std::setprecision;
+
+    options opts;
+    parse(argc, argv, &opts);
+    runtime::configure_default_pool(opts.threads + 1, opts.affinity);
+    bench::cache_misses misses(runtime::default_pool().size());
+
+    cout << std::left
+         << setw(10) << "family"     << setw(10) << "vertices" << setw(11) << "edges"
+         << setw(12) << "engine"     << setw(8)  << "order"    << setw(8)  << "threads"
+         << setw(7)  << "cycle"      << setw(12) << "answer, ms" << setw(12) << "Medges/s"
+         << setw(14) << "misses, M"  << "peak RSS, MB" << endl;
+
+    for (auto f : opts.families) {
+        graph::edge_list const input = bench::generate(f, opts.vertices, opts.degree, opts.seed);
+        graph::csr             graph;
+
+        double const build = measure([&] {
+            graph = graph::build_csr(input.vertices_count, input.edges, opts.threads);
+        });
+        size_t const edges = graph.neighbours_count() / 2;
+        cout << "# " << bench::family_name(f) << ": csr built in " << fixed << setprecision(1)
+             << build * 1000 << " ms with " << opts.threads << " threads" << endl;
+
+        for (auto order : opts.orders) {
+            graph::csr ordered;
+            double const reorder = measure([&] {
+                ordered = graph::reorder(graph, order, opts.threads).graph;
+            });
+            if (order != graph::ordering::NONE) {
+                cout << "# " << bench::family_name(f) << ": reordered by " << graph::ordering_name(order)
+                     << " in " << fixed << setprecision(1) << reorder * 1000 << " ms" << endl;
+            }
+
+            for (auto engine : opts.engines) {
+                for (size_t threads = 1; threads <= opts.threads; ++threads) {
+                    //! Best of repeats
+                    /** Engines stop on the first cycle, so answer time is time-to-first-cycle
+                        on cyclic graphs and a full traversal otherwise. */
+                    bool          cycle       = false;
+                    double        best        = 0;
+                    std::uint64_t best_misses = 0;
+                    for (size_t r = 0; r < opts.repeat; ++r) {
+                        misses.start();
+                        double const seconds = measure([&] {
+                            cycle = engines::run(engine, ordered, threads, engine != engines::engine_type::BFS);
+                        });
+                        std::uint64_t const run_misses = misses.stop();
+
+                        if (r == 0 || seconds < best) {
+                            best        = seconds;
+                            best_misses = run_misses;
+                        }
+                    }
+
+                    //! Throughput
+                    /** Run stopped at the first cycle or searching only from vertex 0 has not
+                        scanned every edge, dividing all of them by its time would inflate it. */
+                    std::ostringstream throughput_column;
+                    if (!cycle && engine != engines::engine_type::BFS) {
+                        throughput_column << fixed << setprecision(2) << double(edges) / best / 1e6;
+                    } else {
+                        throughput_column << "n/a";
+                    }
+
+                    std::ostringstream misses_column;
+                    if (misses.available()) {
+                        misses_column << fixed << setprecision(3) << double(best_misses) / 1e6;
+                    } else {
+                        misses_column << "n/a";
+                    }
+
+                    cout << setw(10) << bench::family_name(f) << setw(10) << ordered.vertices_count()
+                         << setw(11) << edges << setw(12) << engines::engine_name(engine)
+                         << setw(8) << graph::ordering_name(order) << setw(8) << threads
+                         << setw(7) << (cycle ? "yes" : "no")
+                         << setw(12) << fixed << setprecision(3) << best * 1000
+                         << setw(12) << throughput_column.str()
+                         << setw(14) << misses_column.str()
+                         << setprecision(1) << peak_rss_megabytes() << endl;
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (std::exception& e) {
+    using std::cerr;
+    using std::endl;
+
+    cerr << "error: " << e.what() << endl;
+    return EXIT_FAILURE;
+}
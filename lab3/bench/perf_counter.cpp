@@ -0,0 +1,82 @@
+#include "perf_counter.hpp"
+
+#include "runtime/workers.hpp"
+
+#ifdef __linux__
+/* stdlib: */
+#include <mutex>
+
+/* Linux: */
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+bench::cache_misses::cache_misses(size_t workers_count) {
+    std::mutex lock;
+    bool       failed = false;
+
+    runtime::run_workers(workers_count, [&](size_t) {
+        perf_event_attr attributes = {};
+        attributes.type           = PERF_TYPE_HARDWARE;
+        attributes.size           = sizeof(attributes);
+        attributes.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attributes.disabled       = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+
+        // Counter of the calling thread on any processor
+        int const descriptor = int(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (descriptor < 0) {
+            failed = true;
+        } else {
+            descriptors_.push_back(descriptor);
+        }
+    });
+
+    if (failed) {
+        for (int descriptor : descriptors_) {
+            ::close(descriptor);
+        }
+        descriptors_.clear();
+    }
+}
+
+bench::cache_misses::~cache_misses() {
+    for (int descriptor : descriptors_) {
+        ::close(descriptor);
+    }
+}
+
+void bench::cache_misses::start() noexcept {
+    for (int descriptor : descriptors_) {
+        ::ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+std::uint64_t bench::cache_misses::stop() noexcept {
+    std::uint64_t total = 0;
+    for (int descriptor : descriptors_) {
+        ::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+        std::uint64_t value = 0;
+        if (::read(descriptor, &value, sizeof(value)) == sizeof(value)) {
+            total += value;
+        }
+    }
+    return total;
+}
+#else
+bench::cache_misses::cache_misses(size_t) {}
+
+bench::cache_misses::~cache_misses() {}
+
+void bench::cache_misses::start() noexcept {}
+
+std::uint64_t bench::cache_misses::stop() noexcept {
+    return 0;
+}
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+    //! Hardware cache-miss counter of all pool workers
+    /** Uses Linux perf events; every worker of the default pool opens a counter of its own
+        thread, so the persistent pool is measured without inheritance. Where perf events are
+        not available (other systems, restricted kernels) `available` is false. */
+    class cache_misses {
+        std::vector<int> descriptors_;
+
+    public:
+        explicit cache_misses(size_t workers_count);
+        ~cache_misses();
+
+        cache_misses(cache_misses const&) = delete;
+        cache_misses& operator=(cache_misses const&) = delete;
+
+        bool available() const noexcept {
+            return !descriptors_.empty();
+        }
+
+        void start() noexcept;
+
+        //! stop
+        /** Stops counting and returns misses since `start`. */
+        std::uint64_t stop() noexcept;
+    };
+}
@@ -1,4 +1,7 @@
 set(CMAKE_CXX_STANDARD 17)
 
+option(LAB3_INSTRUMENTATION "Collect per-thread counters and phase timeline of the search" OFF)
+option(LAB3_AVX2 "Use AVX2 instructions in the dense engine" OFF)
+
 include(dependecies)
 include(app)
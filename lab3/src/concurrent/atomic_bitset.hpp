@@ -0,0 +1,66 @@
+#pragma once
+
+/* stdlib: */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace concurrent {
+    //! Fixed size bitset with atomic bit claiming
+    /** Bits are packed into 64-bit words grouped by cache lines, so neighbouring vertices
+        share one line and the whole map of a large graph stays V / 8 bytes. */
+    class atomic_bitset {
+        using word = std::uint64_t;
+
+        static auto constexpr bits_per_word  = size_t(64);
+        static auto constexpr words_per_line = size_t(8);
+        static auto constexpr bits_per_line  = bits_per_word * words_per_line;
+
+        struct alignas(64) line {
+            std::atomic<word> words[words_per_line];
+        };
+
+        std::vector<line> lines_;
+
+    public:
+        explicit atomic_bitset(size_t count)
+            : lines_((count + bits_per_line - 1) / bits_per_line) {
+            for (auto& l : lines_) {
+                for (auto& w : l.words) {
+                    w.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        //! claim
+        /** Sets bit `i`. Returns true if the bit was clear, i.e. the caller is the only owner. */
+        bool claim(size_t i) noexcept {
+            word const mask = word(1) << (i % bits_per_word);
+            return (slot(i).fetch_or(mask, std::memory_order_acq_rel) & mask) == 0;
+        }
+
+        //! test
+        /** Returns current value of bit `i`. */
+        bool test(size_t i) const noexcept {
+            word const mask = word(1) << (i % bits_per_word);
+            return (slot(i).load(std::memory_order_acquire) & mask) != 0;
+        }
+
+        //! clear word
+        /** Clears bit `i` together with every bit sharing its word. Lets a sparse set of bits
+            be cleared in the time of its size rather than of the whole bitset. */
+        void clear_word(size_t i) noexcept {
+            slot(i).store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<word>& slot(size_t i) noexcept {
+            return lines_[i / bits_per_line].words[(i / bits_per_word) % words_per_line];
+        }
+
+        std::atomic<word> const& slot(size_t i) const noexcept {
+            return lines_[i / bits_per_line].words[(i / bits_per_word) % words_per_line];
+        }
+    };
+}
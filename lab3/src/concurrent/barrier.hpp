@@ -0,0 +1,49 @@
+#pragma once
+
+/* stdlib: */
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace concurrent {
+    //! Reusable thread barrier
+    /** Last arriving thread opens the barrier by bumping the generation,
+        others spin on it yielding their time slice. */
+    class barrier {
+        size_t const        count_;
+        std::atomic<size_t> arrived_    = 0;
+        std::atomic<size_t> generation_ = 0;
+
+    public:
+        explicit barrier(size_t count)
+            : count_(count) {
+        }
+
+        void arrive_and_wait() noexcept {
+            arrive_and_wait([] {});
+        }
+
+        //! arrive and wait
+        /** Last arriving thread runs `completion` before others are released,
+            so its writes are seen by every thread leaving the barrier. */
+        template<typename callable>
+        void arrive_and_wait(callable&& completion) noexcept {
+            using std::memory_order_acquire;
+            using std::memory_order_release;
+            using std::memory_order_relaxed;
+            using std::memory_order_acq_rel;
+
+            size_t const generation = generation_.load(memory_order_acquire);
+            if (arrived_.fetch_add(1, memory_order_acq_rel) + 1 == count_) {
+                completion();
+                arrived_.store(0, memory_order_relaxed);
+                generation_.fetch_add(1, memory_order_release);
+                return;
+            }
+
+            while (generation_.load(memory_order_acquire) == generation) {
+                std::this_thread::yield();
+            }
+        }
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/* stdlib: */
+#include <atomic>
+#include <vector>
+#include <utility>
+
+#include "graph/csr.hpp"
+
+namespace concurrent {
+    //! Lock-free disjoint set forest
+    /** Roots are linked with compare-and-swap, larger root is always attached to smaller one
+        so forest stays acyclic under any interleaving. `find` compresses paths by halving. */
+    class disjoint_sets {
+        using vertex = graph::vertex;
+
+        std::vector<std::atomic<vertex>> parents_;
+
+    public:
+        explicit disjoint_sets(size_t count)
+            : parents_(count) {
+            for (size_t v = 0; v < count; ++v) {
+                parents_[v].store(vertex(v), std::memory_order_relaxed);
+            }
+        }
+
+        //! find
+        /** Returns current root of the set containing `v`. */
+        vertex find(vertex v) noexcept {
+            using std::memory_order_acquire;
+            using std::memory_order_release;
+            using std::memory_order_relaxed;
+
+            for (;;) {
+                vertex parent = parents_[v].load(memory_order_acquire);
+                if (parent == v) {
+                    return v;
+                }
+
+                vertex const grandparent = parents_[parent].load(memory_order_acquire);
+                if (parent != grandparent) {
+                    // Failure means somebody already shortened the path
+                    parents_[v].compare_exchange_weak(parent, grandparent, memory_order_release, memory_order_relaxed);
+                }
+                v = grandparent;
+            }
+        }
+
+        //! unite
+        /** Merges sets of `u` and `v`. Returns false if they were already in the same set. */
+        bool unite(vertex u, vertex v) noexcept {
+            for (;;) {
+                u = find(u);
+                v = find(v);
+                if (u == v) {
+                    return false;
+                }
+                if (u < v) {
+                    std::swap(u, v);
+                }
+
+                // Link fails only if `u` stopped being a root, so just try again
+                vertex expected = u;
+                if (parents_[u].compare_exchange_strong(expected, v, std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+        }
+    };
+}
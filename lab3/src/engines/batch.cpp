@@ -0,0 +1,39 @@
+#include "engines/batch.hpp"
+
+/* stdlib: */
+#include <atomic>
+
+#include "runtime/workers.hpp"
+
+std::vector<bool> engines::run_batch(std::vector<graph::edge_list> const& graphs, size_t threads_count,
+                                     size_t inline_limit, batch_solver const& solve) {
+    using std::atomic;
+    using std::vector;
+    using std::memory_order_relaxed;
+
+    vector<size_t> small;
+    vector<size_t> large;
+    for (size_t i = 0; i < graphs.size(); ++i) {
+        (graphs[i].edges.size() < inline_limit ? small : large).push_back(i);
+    }
+
+    // Bytes instead of bools, so workers never write to the same word
+    vector<char> answers(graphs.size(), 0);
+
+    //! Small graphs
+    /** One graph per pick keeps workers busy even when sizes differ a lot. */
+    atomic<size_t> next = 0;
+    runtime::run_workers(threads_count, [&](size_t) {
+        for (size_t i = next.fetch_add(1, memory_order_relaxed); i < small.size();
+             i = next.fetch_add(1, memory_order_relaxed)) {
+            answers[small[i]] = solve(graphs[small[i]], 1);
+        }
+    });
+
+    //! Large graphs
+    for (size_t i : large) {
+        answers[i] = solve(graphs[i], threads_count);
+    }
+
+    return vector<bool>(answers.begin(), answers.end());
+}
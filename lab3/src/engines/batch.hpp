@@ -0,0 +1,22 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "graph/loader.hpp"
+
+namespace engines {
+    //! Batch solver
+    /** Answers one graph of a batch using `threads_count` workers. */
+    using batch_solver = std::function<bool(graph::edge_list const& input, size_t threads_count)>;
+
+    //! run batch
+    /** Answers every graph of the batch on the default pool and returns answers in input order.
+        Graphs with fewer than `inline_limit` edges are taken one by one by the workers and solved
+        on a single thread each, so nothing is split or synchronized inside them; larger graphs
+        are then solved one after another with all `threads_count` workers. */
+    std::vector<bool> run_batch(std::vector<graph::edge_list> const& graphs, size_t threads_count,
+                                size_t inline_limit, batch_solver const& solve);
+}
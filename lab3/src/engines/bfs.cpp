@@ -0,0 +1,153 @@
+#include "engines/bfs.hpp"
+
+/* stdlib: */
+#include <atomic>
+#include <vector>
+#include <tuple>
+
+/* Threading building blocks: */
+#include <tbb/concurrent_queue.h>
+
+#include "concurrent/atomic_bitset.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    //! Counters of one worker
+    /** Padded so workers never write to the same cache line. */
+    struct alignas(64) worker_counters {
+        size_t visited = 0;
+        size_t tasks   = 0;
+    };
+}
+
+bool engines::run_parallel_bfs(graph::csr const& graph, size_t threads_count, cycle* witness,
+                               bfs_statistics* statistics) {
+    using std::tuple;
+    using std::vector;
+    using std::atomic;
+    using std::memory_order_relaxed;
+    using std::memory_order_acq_rel;
+    using tbb::concurrent_bounded_queue;
+    using runtime::instrumentation::counter;
+
+    typedef graph::vertex index;
+    typedef graph::vertex from_index;
+
+    enum class task_type {
+        STOP,
+        CONTINUE,
+    };
+
+    using task = tuple<task_type, index, from_index>;
+
+    auto constexpr start = 0;
+
+    //! Synchronization resources
+    /** `pending` counts tasks pushed but not finished yet. A task adds its children before
+        it is finished itself, so the counter drops to zero only when the search is over. */
+    concurrent_bounded_queue<task>   tasks;
+    concurrent::atomic_bitset        map(graph.vertices_count());
+    vector<index>                    parents(graph.vertices_count(), graph::no_vertex);
+    vector<worker_counters>          counters(threads_count);
+    atomic<size_t>                   pending     = 1;
+    atomic<bool>                     cycle_found = false;
+    atomic<bool>                     stopping    = false;
+    graph::edge                      conflict    = {};
+
+    //! Stop search
+    /** Wakes workers blocked on the empty queue. Called once by whoever ends the search. */
+    auto stop = [&]() -> void {
+        if (stopping.exchange(true, memory_order_relaxed)) {
+            return;
+        }
+        for (size_t i = 0; i < threads_count; i++) {
+            tasks.emplace(task_type::STOP, 0, 0);
+        }
+    };
+
+    //! Thread routine.
+    /** Main procedure that is running in each search thread. */
+    auto routine = [&](size_t worker) -> void {
+        auto& own = counters[worker];
+
+        task t;
+        for (;;) {
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::QUEUE_WAIT_NS);
+                tasks.pop(t);
+            }
+
+            // Unpack next task
+            auto [type, current, from] = t;
+
+            // Check task because that may be STOP message, and cancellation of the search
+            if (type == task_type::STOP || cycle_found.load(memory_order_relaxed)) {
+                return;
+            }
+            ++own.tasks;
+
+            //! Claim vertex
+            /** Single `fetch_or` decides who visits `current` first. The winner is the only
+                writer of its parent, so the graph and the parents need no locks. */
+            if (!map.claim(current)) {
+                // Only the first visit of a claimed vertex is kept as the witness
+                if (!cycle_found.exchange(true, memory_order_relaxed)) {
+                    conflict = { from, current };
+                }
+                stop();
+                return;
+            }
+            parents[current] = from;
+            ++own.visited;
+            runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+            runtime::instrumentation::add(worker, counter::EDGES_SCANNED, graph.degree(current));
+
+            // Push new tasks, path we came from is skipped
+            size_t children = 0;
+            for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                children += (*it != from || *it == current);
+            }
+            if (children != 0) {
+                pending.fetch_add(children, memory_order_relaxed);
+            }
+            for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                if (*it != from || *it == current) {
+                    tasks.emplace(task_type::CONTINUE, *it, current);
+                }
+            }
+
+            // The last finished task ends the search
+            if (pending.fetch_sub(1, memory_order_acq_rel) == 1) {
+                stop();
+                return;
+            }
+        }
+    };
+
+    //! Initial state
+    /** Tell first thread to start from vertex with index that equals start. */
+    tasks.emplace(task_type::CONTINUE, start, start);
+
+    // Run search threads and wait for them
+    runtime::run_workers(threads_count, routine);
+
+    bool const answer = cycle_found.load();
+
+    if (statistics) {
+        statistics->visited.clear();
+        statistics->tasks.clear();
+        for (auto& worker_counters : counters) {
+            statistics->visited.push_back(worker_counters.visited);
+            statistics->tasks.push_back(worker_counters.tasks);
+        }
+    }
+
+    //! Witness
+    /** Parents of all visited vertices are written before their workers are joined. */
+    if (witness && answer) {
+        *witness = trace_cycle(graph.vertices_count(), parent_forest(parents), conflict);
+    }
+
+    return answer;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <vector>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! Statistics of the bfs engine
+    /** Per worker counts of visited vertices and of tasks taken from the queue. */
+    struct bfs_statistics {
+        std::vector<size_t> visited;
+        std::vector<size_t> tasks;
+    };
+
+    //! run parallel bfs
+    /** Searches for a cycle in the component of vertex 0. Visits are distributed through
+        one shared task queue, a vertex visited twice means a cycle. The first worker to see
+        a cycle raises a flag every worker checks before the next task; the search is also over
+        once no task is queued or running.
+        If `witness` is given, the found cycle is traced through parents of visited vertices. */
+    bool run_parallel_bfs(graph::csr const& graph, size_t threads_count, cycle* witness = nullptr,
+                          bfs_statistics* statistics = nullptr);
+}
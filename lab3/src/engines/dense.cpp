@@ -0,0 +1,218 @@
+#include "engines/dense.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "concurrent/barrier.hpp"
+#include "graph/bit_matrix.hpp"
+#include "runtime/bits.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+bool engines::run_dense_bfs(graph::csr const& graph, size_t threads_count, bool all_components,
+                            cycle* witness) {
+    using std::atomic;
+    using std::vector;
+    using std::memory_order_relaxed;
+    using graph::vertex;
+    using graph::edge;
+    using graph::no_vertex;
+    using graph::bitmap;
+    using word = bitmap::word;
+    using runtime::instrumentation::counter;
+
+    auto constexpr bits = bitmap::bits_per_word;
+
+    size_t const vertices_count = graph.vertices_count();
+    if (vertices_count == 0) {
+        return false;
+    }
+    threads_count = std::max<size_t>(threads_count, 1);
+
+    graph::bit_matrix const matrix(graph, threads_count);
+    size_t const            words_count = matrix.words_per_row();
+
+    //! Search state
+    /** Visited and frontier bitmaps change only between levels, so workers read them as plain
+        words. New vertices of a level are collected in per-worker claim bitmaps and merged after
+        the barrier. Bits past the last vertex are marked visited and never become frontier. */
+    vector<atomic<vertex>> parents(vertices_count);
+    bitmap                 visited(words_count);
+    bitmap                 frontier(words_count);
+    vector<bitmap>         claims(threads_count, bitmap(words_count));
+    vector<size_t>         claimed(threads_count, 0);
+    concurrent::barrier    level_barrier(threads_count);
+    atomic<size_t>         cursor      = 0;
+    atomic<bool>           cycle_found = false;
+    edge                   conflict    = {};
+    size_t                 next_root   = 0;
+    bool                   stop        = false;
+
+    for (auto& parent : parents) {
+        parent.store(no_vertex, memory_order_relaxed);
+    }
+    for (size_t i = vertices_count; i < words_count * bits; ++i) {
+        visited.words()[i / bits] |= word(1) << (i % bits);
+    }
+
+    //! Seed
+    /** Makes the next unvisited vertex the only vertex of the frontier.
+        Returns false if every vertex is visited. */
+    auto seed = [&]() -> bool {
+        for (; next_root < words_count; ++next_root) {
+            word const unvisited = ~visited.words()[next_root];
+            if (unvisited != 0) {
+                size_t const root = next_root * bits + runtime::count_trailing_zeros(unvisited);
+                parents[root].store(vertex(root), memory_order_relaxed);
+                visited.words()[root / bits]  |= word(1) << (root % bits);
+                frontier.words()[root / bits] |= word(1) << (root % bits);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    //! Report cycle
+    /** Only the first edge closing a cycle is kept as the witness. */
+    auto report = [&](vertex u, vertex w) -> void {
+        if (!cycle_found.exchange(true, memory_order_relaxed)) {
+            conflict = { u, w };
+        }
+    };
+
+    //! Expand vertex
+    /** Returns false if a cycle is found. Parent bit is left out of the visited neighbours
+        unless the vertex is a root, whose self-loop would be hidden by it. */
+    auto expand = [&](vertex current, word* claim) -> bool {
+        word const*  row    = matrix.row(current);
+        word const*  seen   = visited.words();
+        vertex const parent = parents[current].load(memory_order_relaxed);
+
+        auto expand_word = [&](size_t i) -> bool {
+            word known = row[i] & seen[i];
+            if (parent != current && i == parent / bits) {
+                known &= ~(word(1) << (parent % bits));
+            }
+            if (known != 0) {
+                report(current, vertex(i * bits + runtime::count_trailing_zeros(known)));
+                return false;
+            }
+
+            for (word fresh = row[i] & ~seen[i]; fresh != 0; fresh &= fresh - 1) {
+                vertex const neighbour = vertex(i * bits + runtime::count_trailing_zeros(fresh));
+                vertex       expected  = no_vertex;
+                if (!parents[neighbour].compare_exchange_strong(expected, current, memory_order_relaxed)) {
+                    // Claimed by another vertex of the frontier
+                    report(current, neighbour);
+                    return false;
+                }
+                claim[i] |= word(1) << (neighbour % bits);
+            }
+            return true;
+        };
+
+#if defined(__AVX2__)
+        // Rows are whole cache lines, so the last block is never short
+        for (size_t i = 0; i < words_count; i += 4) {
+            __m256i const block = _mm256_load_si256(reinterpret_cast<__m256i const*>(row + i));
+            if (_mm256_testz_si256(block, block)) {
+                continue;
+            }
+            for (size_t k = i; k < i + 4; ++k) {
+                if (!expand_word(k)) {
+                    return false;
+                }
+            }
+        }
+#else
+        for (size_t i = 0; i < words_count; ++i) {
+            if (row[i] != 0 && !expand_word(i)) {
+                return false;
+            }
+        }
+#endif
+        return true;
+    };
+
+    if (!all_components) {
+        parents[0].store(0, memory_order_relaxed);
+        visited.words()[0]  |= 1;
+        frontier.words()[0] |= 1;
+    } else {
+        seed();
+    }
+
+    //! Thread routine.
+    auto routine = [&](size_t worker) -> void {
+        word* const claim = claims[worker].words();
+
+        for (;;) {
+            //! Expand frontier words taken in turn
+            size_t i;
+            while (!cycle_found.load(memory_order_relaxed)
+                   && (i = cursor.fetch_add(1, memory_order_relaxed)) < words_count) {
+                for (word set = frontier.words()[i]; set != 0; set &= set - 1) {
+                    vertex const current = vertex(i * bits + runtime::count_trailing_zeros(set));
+                    runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+                    runtime::instrumentation::add(worker, counter::EDGES_SCANNED, graph.degree(current));
+                    if (!expand(current, claim)) {
+                        break;
+                    }
+                }
+            }
+
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait();
+            }
+
+            //! Merge claims
+            /** Each worker merges its own slice of words of all claim bitmaps into the next frontier. */
+            auto [first, last] = runtime::split(words_count, threads_count, worker);
+            size_t count = 0;
+            for (size_t k = first; k < last; ++k) {
+                word merged = 0;
+                for (auto& other : claims) {
+                    merged |= other.words()[k];
+                    other.words()[k] = 0;
+                }
+                frontier.words()[k]  = merged;
+                visited.words()[k]  |= merged;
+                count += runtime::popcount(merged);
+            }
+            claimed[worker] = count;
+
+            // Next level or next component is decided once for everybody
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait([&] {
+                    cursor.store(0, memory_order_relaxed);
+                    stop = cycle_found.load(memory_order_relaxed);
+                    if (!stop && std::all_of(claimed.begin(), claimed.end(), [](size_t c) { return c == 0; })) {
+                        stop = !all_components || !seed();
+                    }
+                });
+            }
+
+            if (stop) {
+                return;
+            }
+        }
+    };
+
+    runtime::run_workers(threads_count, routine);
+
+    //! Witness
+    /** Parents are final once workers are joined, both ends of the conflict are claimed. */
+    if (witness && cycle_found.load()) {
+        *witness = trace_cycle(vertices_count, parent_forest(parents), conflict);
+    }
+
+    return cycle_found.load();
+}
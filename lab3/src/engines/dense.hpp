@@ -0,0 +1,23 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run dense bfs
+    /** Level-synchronous search from vertex 0 over the adjacency matrix of the graph, see
+        `graph::bit_matrix`. Frontier and visited vertices are bitmaps too, so a row is expanded
+        a word at a time: `row & visited` other than the parent is a closed cycle and
+        `row & ~visited` are the new vertices, walked by their set bits. With AVX2 the empty
+        parts of a row are skipped four words at once. Workers take frontier words in turn
+        and claim new vertices by setting their parent; a second claim closes a cycle too.
+
+        Pays off on dense graphs, where a row of V / 64 words replaces a much longer list of
+        neighbours; the matrix limits the graph to `graph::bit_matrix::max_vertices`.
+        If `all_components` is set, components are searched one after another. */
+    bool run_dense_bfs(graph::csr const& graph, size_t threads_count, bool all_components = false,
+                       cycle* witness = nullptr);
+}
@@ -0,0 +1,118 @@
+#include "engines/directed.hpp"
+
+/* stdlib: */
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "concurrent/atomic_bitset.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+bool engines::run_directed_trim(graph::csr const& graph, size_t threads_count, cycle* witness) {
+    using std::atomic;
+    using std::vector;
+    using std::uint32_t;
+    using std::memory_order_relaxed;
+    using graph::vertex;
+    using runtime::instrumentation::counter;
+
+    auto constexpr chunk_size = size_t(1024);
+
+    size_t const     vertices_count = graph.vertices_count();
+    graph::csr const reversed       = graph::transpose(graph, threads_count);
+
+    //! Search state
+    /** Counts of edges to and from vertices not trimmed yet. Rows have no duplicates,
+        so a degree always fits in a vertex index. */
+    vector<atomic<uint32_t>>  in_left(vertices_count);
+    vector<atomic<uint32_t>>  out_left(vertices_count);
+    concurrent::atomic_bitset trimmed(vertices_count);
+    atomic<size_t>            next_chunk    = 0;
+    atomic<size_t>            trimmed_count = 0;
+
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t v = first; v < last; ++v) {
+            in_left[v].store(uint32_t(reversed.degree(vertex(v))), memory_order_relaxed);
+            out_left[v].store(uint32_t(graph.degree(vertex(v))), memory_order_relaxed);
+        }
+    });
+
+    //! Thread routine.
+    /** A vertex is trimmed by whoever claims it first: either the scanner seeing a zero degree
+        or the worker whose removal dropped the degree to zero. */
+    auto routine = [&](size_t worker) -> void {
+        vector<vertex> stack;
+        size_t         count = 0;
+
+        auto trim = [&](vertex v) -> void {
+            if (trimmed.claim(v)) {
+                stack.push_back(v);
+            }
+        };
+
+        for (;;) {
+            size_t const first = next_chunk.fetch_add(chunk_size, memory_order_relaxed);
+            if (first >= vertices_count) {
+                break;
+            }
+            size_t const last = std::min(first + chunk_size, vertices_count);
+
+            for (size_t v = first; v < last; ++v) {
+                if (in_left[v].load(memory_order_relaxed) == 0 || out_left[v].load(memory_order_relaxed) == 0) {
+                    trim(vertex(v));
+                }
+
+                // Removed edges of trimmed vertices may expose more of them
+                while (!stack.empty()) {
+                    vertex const current = stack.back();
+                    stack.pop_back();
+                    ++count;
+                    runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+                    runtime::instrumentation::add(worker, counter::EDGES_SCANNED,
+                                                  graph.degree(current) + reversed.degree(current));
+
+                    for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                        if (in_left[*it].fetch_sub(1, memory_order_relaxed) == 1) {
+                            trim(*it);
+                        }
+                    }
+                    for (auto it = reversed.begin(current); it != reversed.end(current); ++it) {
+                        if (out_left[*it].fetch_sub(1, memory_order_relaxed) == 1) {
+                            trim(*it);
+                        }
+                    }
+                }
+            }
+        }
+
+        trimmed_count.fetch_add(count, memory_order_relaxed);
+    };
+
+    runtime::run_workers(threads_count, routine);
+
+    bool const cycle_found = trimmed_count.load() != vertices_count;
+
+    //! Witness
+    /** Walk surviving successors from any survivor until some vertex repeats. */
+    if (witness && cycle_found) {
+        vertex current = 0;
+        while (trimmed.test(current)) {
+            ++current;
+        }
+
+        vector<size_t> positions(vertices_count, vertices_count);
+        vector<vertex> walk;
+        while (positions[current] == vertices_count) {
+            positions[current] = walk.size();
+            walk.push_back(current);
+            current = *std::find_if(graph.begin(current), graph.end(current),
+                                    [&](vertex w) { return !trimmed.test(w); });
+        }
+        witness->assign(walk.begin() + positions[current], walk.end());
+    }
+
+    return cycle_found;
+}
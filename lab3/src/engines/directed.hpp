@@ -0,0 +1,22 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run directed trim
+    /** Searches for a directed cycle, i.e. a strongly connected component with more than one
+        vertex or a self-loop. Vertices without incoming or without outgoing edges can not lie
+        on a cycle, so they are trimmed and their edges removed until nothing more can be
+        trimmed. The graph is acyclic if and only if every vertex is trimmed: each survivor has
+        a surviving successor, so walking successors must come back.
+
+        Workers scan chunks of vertices for the first trimmable ones and keep trimming whatever
+        their removals expose on their own stacks, so no barriers are needed. In-edges are taken
+        from the transposed graph built first.
+        If `witness` is given, the found cycle is traced by walking surviving successors. */
+    bool run_directed_trim(graph::csr const& graph, size_t threads_count, cycle* witness = nullptr);
+}
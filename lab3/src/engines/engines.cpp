@@ -0,0 +1,131 @@
+#include "engines/engines.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "engines/bfs.hpp"
+#include "engines/dense.hpp"
+#include "engines/frontier.hpp"
+#include "engines/hybrid.hpp"
+#include "engines/sequential.hpp"
+#include "engines/union_find.hpp"
+#include "runtime/thread_pool.hpp"
+
+engines::engine_type engines::parse_engine(std::string const& name) {
+    using std::runtime_error;
+
+    if (name == "bfs") {
+        return engine_type::BFS;
+    }
+    if (name == "union-find") {
+        return engine_type::UNION_FIND;
+    }
+    if (name == "frontier") {
+        return engine_type::FRONTIER;
+    }
+    if (name == "dfs") {
+        return engine_type::SEQUENTIAL;
+    }
+    if (name == "dense") {
+        return engine_type::DENSE;
+    }
+    if (name == "hybrid") {
+        return engine_type::HYBRID;
+    }
+    if (name == "auto") {
+        return engine_type::AUTO;
+    }
+
+    throw runtime_error("unknown engine '" + name + "'");
+}
+
+char const* engines::engine_name(engine_type engine) noexcept {
+    switch (engine) {
+    case engine_type::BFS:
+        return "bfs";
+    case engine_type::UNION_FIND:
+        return "union-find";
+    case engine_type::FRONTIER:
+        return "frontier";
+    case engine_type::SEQUENTIAL:
+        return "dfs";
+    case engine_type::DENSE:
+        return "dense";
+    case engine_type::HYBRID:
+        return "hybrid";
+    case engine_type::AUTO:
+        return "auto";
+    }
+
+    return "unknown";
+}
+
+engines::plan engines::choose_plan(graph::csr const& graph, size_t max_threads_count) {
+    //! Cost model
+    /** Sequential search touches every row and every neighbour about once; the constants are
+        the costs of a cached row and neighbour, so the estimate is low and workers are added
+        only when they surely pay. A worker pays for a few pool jobs and level barriers, so it
+        must get `work_per_overhead` times more work than one job costs. Waking even one worker
+        takes microseconds, graphs below `least_overhead` are not worth measuring the pool. */
+    auto constexpr seconds_per_vertex    = 4e-9;
+    auto constexpr seconds_per_neighbour = 2e-9;
+    auto constexpr work_per_overhead     = 50.0;
+    auto constexpr least_overhead        = 2e-6;
+
+    double const sequential = double(graph.vertices_count()) * seconds_per_vertex
+                            + double(graph.neighbours_count()) * seconds_per_neighbour;
+
+    static std::mutex measure_lock;
+    static double     overhead               = 0;
+    static size_t     overhead_threads_count = 0;
+
+    max_threads_count = std::max<size_t>(max_threads_count, 1);
+    if (max_threads_count == 1 || sequential < work_per_overhead * least_overhead) {
+        return { engine_type::SEQUENTIAL, 1 };
+    }
+
+    double job;
+    {
+        std::lock_guard<std::mutex> guard(measure_lock);
+        if (overhead_threads_count != max_threads_count) {
+            overhead               = runtime::default_pool().job_overhead(max_threads_count);
+            overhead_threads_count = max_threads_count;
+        }
+        job = overhead;
+    }
+
+    size_t const threads_count = std::min(max_threads_count, size_t(sequential / (work_per_overhead * job)));
+    if (threads_count <= 1) {
+        return { engine_type::SEQUENTIAL, 1 };
+    }
+    return { engine_type::FRONTIER, threads_count };
+}
+
+bool engines::run(engine_type engine, graph::csr const& graph, size_t threads_count, bool all_components,
+                  cycle* witness) {
+    switch (engine) {
+    case engine_type::BFS:
+        if (all_components) {
+            throw std::runtime_error("engine 'bfs' searches only from vertex 0");
+        }
+        return run_parallel_bfs(graph, threads_count, witness);
+    case engine_type::UNION_FIND:
+        return run_union_find(graph, threads_count, witness);
+    case engine_type::FRONTIER:
+        return run_frontier_bfs(graph, threads_count, all_components, witness);
+    case engine_type::SEQUENTIAL:
+        return run_sequential_dfs(graph, all_components, witness);
+    case engine_type::DENSE:
+        return run_dense_bfs(graph, threads_count, all_components, witness);
+    case engine_type::HYBRID:
+        return run_hybrid_bfs(graph, threads_count, all_components, witness);
+    case engine_type::AUTO: {
+        plan const chosen = choose_plan(graph, threads_count);
+        return run(chosen.engine, graph, chosen.threads_count, all_components, witness);
+    }
+    }
+
+    return false;
+}
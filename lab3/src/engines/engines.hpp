@@ -0,0 +1,50 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <string>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! Search engines
+    enum class engine_type {
+        BFS,
+        UNION_FIND,
+        FRONTIER,
+        SEQUENTIAL,
+        DENSE,
+        HYBRID,
+        AUTO,
+    };
+
+    //! Engine and workers chosen for a graph
+    struct plan {
+        engine_type engine;
+        size_t      threads_count;
+    };
+
+    //! parse engine
+    /** Returns engine by its command line name, throws `std::runtime_error` for unknown one. */
+    engine_type parse_engine(std::string const& name);
+
+    //! engine name
+    /** Returns command line name of the engine. */
+    char const* engine_name(engine_type engine) noexcept;
+
+    //! choose plan
+    /** Picks engine and workers count for the automatic engine. Sequential search time is
+        estimated from the size of the graph; workers are added only while each of them still
+        gets work worth many times the measured cost of a pool job, so small graphs are searched
+        by the sequential engine without starting any worker. `max_threads_count` is an upper
+        bound. The pool is measured once, on the first graph large enough to need it. */
+    plan choose_plan(graph::csr const& graph, size_t max_threads_count);
+
+    //! run
+    /** Runs selected engine. Threads count is an upper bound for the automatic engine. `all_components` requests search in every component,
+        engines not able to do it throw `std::runtime_error`. If `witness` is given and
+        a cycle is found, its vertices are stored there. */
+    bool run(engine_type engine, graph::csr const& graph, size_t threads_count, bool all_components,
+             cycle* witness = nullptr);
+}
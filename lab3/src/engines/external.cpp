@@ -0,0 +1,367 @@
+#include "engines/external.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "concurrent/atomic_bitset.hpp"
+#include "concurrent/disjoint_sets.hpp"
+#include "graph/loader.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    using graph::vertex;
+    using graph::edge;
+
+    //! More open spill files than this may hit limits of the C runtime
+    auto constexpr max_buckets = size_t(256);
+
+    //! Spill file
+    /** Binary file of edges in the spill directory, removed when closed. */
+    class spill_file {
+        std::filesystem::path path_;
+        std::FILE*            file_ = nullptr;
+
+    public:
+        explicit spill_file(std::filesystem::path const& directory) {
+            static std::atomic<size_t> counter = 0;
+
+            auto const stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+            path_ = directory / ("lab3-" + std::to_string(stamp) + "-" + std::to_string(counter++) + ".spill");
+            file_ = std::fopen(path_.string().c_str(), "w+b");
+            if (file_ == nullptr) {
+                throw std::runtime_error("can not create spill file '" + path_.string() + "'");
+            }
+        }
+
+        ~spill_file() {
+            std::fclose(file_);
+            std::error_code error;
+            std::filesystem::remove(path_, error);
+        }
+
+        spill_file(spill_file const&) = delete;
+        spill_file& operator=(spill_file const&) = delete;
+
+        void write(edge const* edges, size_t count) {
+            if (std::fwrite(edges, sizeof(edge), count, file_) != count) {
+                throw std::runtime_error("can not write spill file '" + path_.string() + "'");
+            }
+        }
+
+        //! Moves to the first edge, switching the file from writing to reading
+        void rewind() {
+            std::fflush(file_);
+            std::rewind(file_);
+        }
+
+        size_t read(edge* edges, size_t count) {
+            size_t const read = std::fread(edges, sizeof(edge), count, file_);
+            if (read < count && std::ferror(file_)) {
+                throw std::runtime_error("can not read spill file '" + path_.string() + "'");
+            }
+            return read;
+        }
+    };
+
+    //! Bucket of edges
+    /** Edges are kept in `buffer` until it is full, then appended to the spill file. */
+    struct bucket {
+        std::vector<edge>           buffer;
+        std::unique_ptr<spill_file> file;
+        size_t                      count = 0;
+    };
+
+    //! bucket of
+    /** Mixes the edge with `level` (splitmix64 finalizer), so copies of one edge always land in
+        one bucket while a bucket partitioned again spreads over new ones. */
+    size_t bucket_of(edge e, size_t level, size_t buckets_count) noexcept {
+        std::uint64_t x = ((std::uint64_t(e.u) << 32) | e.v) + 0x9E3779B97F4A7C15 * (level + 1);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+        x ^= x >> 31;
+        return size_t(x % buckets_count);
+    }
+
+    //! Out-of-core search state
+    /** Budget left after the forest is split in halves: one for bucket buffers and input blocks,
+        one for the bucket being merged. Bucket partitioned again splits its merge half the same
+        way, so every level merges at most half of the edges the level above does. */
+    class external_search {
+        using clock = std::chrono::steady_clock;
+
+        //! Deepest partition
+        /** Bucket still too large after this many partitions is made of copies of few edges. */
+        static auto constexpr max_level = size_t(8);
+
+        engines::external_settings const& settings_;
+        std::filesystem::path             directory_;
+        concurrent::disjoint_sets         sets_;
+        concurrent::atomic_bitset         cyclic_;
+        size_t                            capacity_;
+        engines::external_progress        progress_;
+        clock::time_point                 stage_begin_;
+
+    public:
+        external_search(engines::external_settings const& settings, size_t vertices_count, size_t working_bytes)
+            : settings_(settings)
+            , sets_(vertices_count)
+            , cyclic_(settings.all_components ? 0 : vertices_count)
+            , capacity_(working_bytes / 2 / sizeof(edge)) {
+            directory_ = settings.spill_directory.empty() ? std::filesystem::temp_directory_path()
+                                                          : std::filesystem::path(settings.spill_directory);
+        }
+
+        //! Starts a stage of the progress report
+        void begin_stage(char const* stage, size_t bytes_total) {
+            progress_.stage       = stage;
+            progress_.bytes_done  = 0;
+            progress_.bytes_total = bytes_total;
+            stage_begin_          = clock::now();
+        }
+
+        //! Reports `bytes` more done in the current stage
+        void advance(size_t bytes) {
+            progress_.bytes_done += bytes;
+            progress_.seconds     = std::chrono::duration<double>(clock::now() - stage_begin_).count();
+            if (settings_.progress) {
+                settings_.progress(progress_);
+            }
+        }
+
+        //! make buckets
+        /** Returns up to `count` empty buckets sharing `buffer_bytes` of buffers. Buffer smaller
+            than the minimum spills too often, so fewer buckets are made instead of exceeding the bytes. */
+        static std::vector<bucket> make_buckets(size_t count, size_t buffer_bytes) {
+            auto constexpr minimum_buffer = size_t(4096);
+
+            count = std::clamp<size_t>(buffer_bytes / (minimum_buffer * sizeof(edge)), 1, count);
+
+            std::vector<bucket> buckets(count);
+            for (auto& b : buckets) {
+                b.buffer.reserve(std::max<size_t>(buffer_bytes / count / sizeof(edge), 1));
+            }
+            return buckets;
+        }
+
+        //! Appends edge with ordered ends to its bucket, spilling the full buffer
+        void put(std::vector<bucket>& buckets, edge e, size_t level) {
+            bucket& b = buckets[bucket_of(e, level, buckets.size())];
+            if (b.buffer.size() == b.buffer.capacity()) {
+                if (!b.file) {
+                    b.file = std::make_unique<spill_file>(directory_);
+                }
+                b.file->write(b.buffer.data(), b.buffer.size());
+                progress_.bytes_spilled += b.buffer.size() * sizeof(edge);
+                b.buffer.clear();
+            }
+            b.buffer.push_back(e);
+            ++b.count;
+        }
+
+        //! Marks vertex on a cycle, returns true if the search is over
+        bool close(vertex v) {
+            if (settings_.all_components) {
+                return true;
+            }
+            cyclic_.claim(v);
+            return false;
+        }
+
+        //! Edges merged at once by a bucket of `level`
+        size_t capacity(size_t level) const noexcept {
+            return std::max<size_t>(capacity_ >> level, 1);
+        }
+
+        //! merge
+        /** Unites ends of distinct edges of `b` and frees it. Returns true if the search is over. */
+        bool merge(bucket& b, size_t level) {
+            using std::vector;
+            using std::atomic;
+            using std::memory_order_relaxed;
+
+            if (b.count == 0) {
+                return false;
+            }
+            if (b.count > capacity(level)) {
+                return partition_again(b, level);
+            }
+
+            vector<edge> edges;
+            edges.reserve(b.count);
+            if (b.file) {
+                b.file->rewind();
+                edges.resize(b.count - b.buffer.size());
+                if (b.file->read(edges.data(), edges.size()) != edges.size()) {
+                    throw std::runtime_error("spill file is truncated");
+                }
+                b.file.reset();
+            }
+            edges.insert(edges.end(), b.buffer.begin(), b.buffer.end());
+            vector<edge>().swap(b.buffer);
+
+            auto const less = [](edge a, edge c) {
+                return a.u < c.u || (a.u == c.u && a.v < c.v);
+            };
+            auto const same = [](edge a, edge c) {
+                return a.u == c.u && a.v == c.v;
+            };
+            std::sort(edges.begin(), edges.end(), less);
+            edges.erase(std::unique(edges.begin(), edges.end(), same), edges.end());
+
+            //! Unite ends
+            /** Set of both ends already being one means the edge closes a cycle. */
+            size_t const threads_count = std::max<size_t>(settings_.threads_count, 1);
+            atomic<bool> over          = false;
+            runtime::run_workers(threads_count, [&](size_t worker) {
+                auto [first, last] = runtime::split(edges.size(), threads_count, worker);
+                for (size_t i = first; i < last && !over.load(memory_order_relaxed); ++i) {
+                    if (!sets_.unite(edges[i].u, edges[i].v) && close(edges[i].u)) {
+                        over.store(true, memory_order_relaxed);
+                    }
+                }
+            });
+
+            advance(b.count * sizeof(edge));
+            b.count = 0;
+
+            return over.load();
+        }
+
+        //! partition again
+        /** Spreads edges of `b`, larger than its merge half, over new buckets by the hash of
+            the next level, and merges them. Buffers of the new buckets and the read block take
+            half of the merge half, the new buckets are merged within the other one. */
+        bool partition_again(bucket& b, size_t level) {
+            using std::vector;
+
+            if (level == max_level) {
+                throw std::runtime_error("too many copies of one edge for the memory budget");
+            }
+
+            size_t const quarter = std::max<size_t>(capacity(level) / 4, 1);
+            size_t const parts   = std::min(max_buckets, (b.count + capacity(level + 1) - 1) / capacity(level + 1) + 1);
+            vector<bucket> buckets = make_buckets(parts, quarter * sizeof(edge));
+
+            if (b.file) {
+                b.file->rewind();
+                vector<edge> block(quarter);
+                for (size_t read; (read = b.file->read(block.data(), block.size())) != 0;) {
+                    for (size_t i = 0; i < read; ++i) {
+                        put(buckets, block[i], level + 1);
+                    }
+                }
+                b.file.reset();
+            }
+            for (auto e : b.buffer) {
+                put(buckets, e, level + 1);
+            }
+            vector<edge>().swap(b.buffer);
+            b.count = 0;
+
+            for (auto& part : buckets) {
+                if (merge(part, level + 1)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //! Returns true if the set of `start` closes a cycle, valid once all edges are merged
+        bool component_cyclic(vertex start, size_t vertices_count) {
+            vertex const root = sets_.find(start);
+            for (size_t v = 0; v < vertices_count; ++v) {
+                if (cyclic_.test(v) && sets_.find(vertex(v)) == root) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+}
+
+bool engines::run_external(std::string const& path, external_settings const& settings) {
+    using std::vector;
+    using std::runtime_error;
+
+    auto constexpr megabyte          = size_t(1) << 20;
+    auto constexpr minimum_working   = 16 * megabyte;
+    auto constexpr maximum_block     = 64 * megabyte;
+    auto constexpr first_block       = megabyte;
+
+    //! Forest and marks
+    /** Number of vertices is known only from the header, read through a small first block. */
+    auto stream = std::make_unique<graph::edge_stream>(path, first_block, settings.threads_count);
+    size_t const vertices_count = stream->vertices_count();
+    size_t const forest_bytes   = vertices_count * sizeof(vertex)
+                                + (settings.all_components ? 0 : vertices_count / 8);
+    if (settings.memory_budget < forest_bytes + minimum_working) {
+        throw runtime_error("memory budget must be at least "
+                            + std::to_string((forest_bytes + minimum_working + megabyte - 1) / megabyte) + " MB");
+    }
+    size_t const working = settings.memory_budget - forest_bytes;
+
+    external_search search(settings, vertices_count, working);
+
+    //! Partition pass
+    /** Input block and its edges take about three blocks of the partition half. */
+    size_t const block_size   = std::clamp(working / 16, first_block, maximum_block);
+    size_t const buffer_bytes = working / 2 - 3 * block_size;
+    size_t const total_bytes  = stream->total_bytes();
+    stream->resize_block(block_size);
+
+    search.begin_stage("partition", total_bytes);
+
+    vector<edge>   edges;
+    vector<bucket> buckets;
+    size_t         reported = 0;
+    while (stream->next(edges)) {
+        //! Buckets count
+        /** Input size over the bytes per edge of the first block estimates all edges;
+            every bucket is meant to fit in the merge half. Unknown size takes the most. */
+        if (buckets.empty()) {
+            size_t count = max_buckets;
+            if (total_bytes != 0 && !edges.empty()) {
+                double const estimate = double(edges.size()) * double(total_bytes) / double(stream->bytes_read());
+                count = std::min(max_buckets, size_t(estimate * 1.25 / double(search.capacity(0))) + 1);
+            }
+            buckets = external_search::make_buckets(count, buffer_bytes);
+        }
+
+        for (auto e : edges) {
+            if (e.u == e.v) {
+                if (search.close(e.u)) {
+                    return true;
+                }
+                continue;
+            }
+            search.put(buckets, e.u < e.v ? e : edge{ e.v, e.u }, 0);
+        }
+
+        search.advance(stream->bytes_read() - reported);
+        reported = stream->bytes_read();
+    }
+    stream.reset();
+
+    //! Merge pass
+    size_t bucketed = 0;
+    for (auto const& b : buckets) {
+        bucketed += b.count * sizeof(edge);
+    }
+    search.begin_stage("merge", bucketed);
+
+    for (auto& b : buckets) {
+        if (search.merge(b, 0)) {
+            return true;
+        }
+    }
+
+    return !settings.all_components && search.component_cyclic(0, vertices_count);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace engines {
+    //! Progress of the out-of-core search
+    struct external_progress {
+        char const* stage         = "";  ///< "partition" or "merge"
+        size_t      bytes_done    = 0;   ///< input bytes read or spilled bytes merged
+        size_t      bytes_total   = 0;   ///< 0 if not known
+        size_t      bytes_spilled = 0;   ///< bytes written to spill files so far
+        double      seconds       = 0;   ///< since the stage began
+
+        double megabytes_per_second() const noexcept {
+            return seconds > 0 ? double(bytes_done) / (1024 * 1024) / seconds : 0;
+        }
+    };
+
+    using progress_callback = std::function<void(external_progress const&)>;
+
+    //! Out-of-core search settings
+    struct external_settings {
+        size_t            memory_budget   = size_t(1) << 30;
+        std::string       spill_directory;   ///< system temporary directory if empty
+        size_t            threads_count   = 1;
+        bool              all_components  = false;
+        progress_callback progress;
+    };
+
+    //! run external
+    /** Searches a cycle in the text edge list at `path`, stdin if it is empty, which does not
+        have to fit in memory. Only a disjoint set forest of the vertices, 4 bytes per vertex,
+        is kept for the whole run; everything else fits in `memory_budget` bytes.
+
+        Partition pass streams the input once and scatters edges, ends ordered, into buckets by
+        a hash of the edge, so copies of one edge meet in one bucket. Buckets are buffered in
+        memory and spilled to files in `spill_directory` when the input is larger than the budget.
+        Merge pass loads the buckets one by one, drops repeated edges and unites the ends of
+        the rest by `threads_count` workers: an edge inside one set closes a cycle. A bucket
+        larger than the budget is partitioned again with another hash.
+
+        Search of all components stops at the first cycle. Otherwise sets closing a cycle are
+        marked, a bit per vertex, and the set of vertex 0 is checked at the end.
+        `progress` is called after every block of input and every merged bucket.
+        Throws `std::runtime_error` if the forest does not fit in the budget or a spill fails. */
+    bool run_external(std::string const& path, external_settings const& settings);
+}
@@ -0,0 +1,239 @@
+#include "engines/frontier.hpp"
+
+/* stdlib: */
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "concurrent/barrier.hpp"
+#include "concurrent/disjoint_sets.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    //! Chunks of the frontier owned by one worker
+    /** `next` is advanced by the owner and by thieves, `last` is written only between levels. */
+    struct alignas(64) chunk_range {
+        std::atomic<size_t> next = 0;
+        size_t              last = 0;
+    };
+}
+
+bool engines::run_frontier_bfs(graph::csr const& graph, size_t threads_count, bool all_components,
+                               cycle* witness) {
+    using std::atomic;
+    using std::vector;
+    using std::memory_order_relaxed;
+    using graph::vertex;
+    using graph::edge;
+    using graph::no_vertex;
+    using runtime::instrumentation::counter;
+
+    auto constexpr start           = vertex(0);
+    auto constexpr chunk_size      = size_t(256);
+    auto constexpr seeds_per_batch = size_t(1024);
+
+    size_t const vertices_count = graph.vertices_count();
+
+    //! Search state
+    /** Every vertex appears in at most one frontier, so both buffers have V slots.
+        Owner is the root of the tree a vertex belongs to, it is written only by the claimer
+        and read by others after the level barrier. */
+    vector<atomic<vertex>>    parents(vertices_count);
+    vector<vertex>            owners(all_components ? vertices_count : 0);
+    vector<vertex>            frontiers[2] = { vector<vertex>(vertices_count), vector<vertex>(vertices_count) };
+    vector<vector<vertex>>    locals(threads_count);
+    vector<vector<edge>>      crossings(threads_count);
+    vector<chunk_range>       ranges(threads_count);
+    concurrent::barrier       level_barrier(threads_count);
+    vector<vector<edge>>      links(threads_count);
+    atomic<bool>              cycle_found = false;
+    edge                      conflict    = {};
+    bool                      stop        = false;
+
+    for (auto& parent : parents) {
+        parent.store(no_vertex, memory_order_relaxed);
+    }
+
+    //! Trees seen meeting each other
+    /** Allocated only if `all_components` is set. */
+    std::unique_ptr<concurrent::disjoint_sets> trees;
+    if (all_components) {
+        trees = std::make_unique<concurrent::disjoint_sets>(vertices_count);
+    }
+
+    //! Initial state
+    /** Root is its own parent, the whole first frontier belongs to worker 0.
+        Search of all components starts with an empty frontier so the first step seeds it. */
+    size_t initial = 0;
+    if (!all_components) {
+        parents[start].store(start, memory_order_relaxed);
+        frontiers[0][0] = start;
+        ranges[0].last  = 1;
+        initial         = 1;
+    }
+
+    //! Take chunk
+    /** Returns first vertex of the taken chunk in `first` or false if `range` is exhausted. */
+    auto take = [](chunk_range& range, size_t* first) -> bool {
+        if (range.next.load(memory_order_relaxed) >= range.last) {
+            return false;
+        }
+        *first = range.next.fetch_add(chunk_size, memory_order_relaxed);
+        return *first < range.last;
+    };
+
+    //! Report cycle
+    /** Only the first edge closing a cycle is kept as the witness. */
+    auto report = [&](vertex u, vertex w) -> void {
+        if (!cycle_found.exchange(true, memory_order_relaxed)) {
+            conflict = { u, w };
+        }
+    };
+
+    //! Thread routine.
+    auto routine = [&](size_t worker) -> void {
+        auto& local    = locals[worker];
+        auto& crossing = crossings[worker];
+
+        // Next candidate seed in own slice of vertices
+        auto [seed, seeds_end] = runtime::split(vertices_count, threads_count, worker);
+
+        size_t total = initial;
+        for (size_t level = 0;; ++level) {
+            vector<vertex> const& frontier = frontiers[level % 2];
+            vector<vertex>&       next     = frontiers[(level + 1) % 2];
+
+            //! Expand vertices of the chunk
+            /** Non-tree edge inside one tree is a cycle. When trees may meet, owners are not
+                known yet, so the edge is kept until the barrier. It is seen from both ends,
+                only the end with smaller index keeps it. */
+            auto expand = [&](size_t first, size_t last) -> void {
+                for (size_t i = first; i < last; ++i) {
+                    vertex const current = frontier[i];
+                    vertex const from    = parents[current].load(memory_order_relaxed);
+                    runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+                    runtime::instrumentation::add(worker, counter::EDGES_SCANNED, graph.degree(current));
+                    vertex const owner   = all_components ? owners[current] : start;
+
+                    for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                        vertex neighbour = *it;
+                        if (neighbour == from && neighbour != current) {
+                            continue;
+                        }
+
+                        vertex expected = no_vertex;
+                        if (parents[neighbour].compare_exchange_strong(expected, current, memory_order_relaxed)) {
+                            if (all_components) {
+                                owners[neighbour] = owner;
+                            }
+                            local.push_back(neighbour);
+                            continue;
+                        }
+
+                        // Claimed from another edge or self-loop
+                        if (!all_components || neighbour == current) {
+                            report(current, neighbour);
+                            return;
+                        }
+                        if (current < neighbour) {
+                            crossing.push_back({ current, neighbour });
+                        }
+                    }
+                }
+            };
+
+            if (total != 0) {
+                // Own chunks first, then steal from others
+                for (size_t offset = 0; offset < threads_count; ++offset) {
+                    auto& range = ranges[(worker + offset) % threads_count];
+
+                    size_t first;
+                    while (!cycle_found.load(memory_order_relaxed) && take(range, &first)) {
+                        expand(first, std::min(first + chunk_size, range.last));
+                    }
+                }
+            } else {
+                // Frontier is empty, seed new trees from unvisited vertices
+                for (; seed < seeds_end && local.size() < seeds_per_batch; ++seed) {
+                    vertex expected = no_vertex;
+                    if (parents[seed].compare_exchange_strong(expected, vertex(seed), memory_order_relaxed)) {
+                        owners[seed] = vertex(seed);
+                        local.push_back(vertex(seed));
+                    }
+                }
+            }
+
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait();
+            }
+
+            //! Resolve edges between trees
+            /** Owners of all claimed vertices are published by the barrier. */
+            for (auto [u, w] : crossing) {
+                if (cycle_found.load(memory_order_relaxed)) {
+                    break;
+                }
+                if (owners[u] == owners[w] || !trees->unite(owners[u], owners[w])) {
+                    report(u, w);
+                } else if (witness) {
+                    links[worker].push_back({ u, w });
+                }
+            }
+            crossing.clear();
+
+            //! Merge local buffers
+            /** Each worker copies its buffer to the offset given by sizes of preceding buffers
+                and prepares own range of the next level. */
+            size_t const previous = total;
+            size_t       offset   = 0;
+            total = 0;
+            for (size_t i = 0; i < threads_count; ++i) {
+                if (i == worker) {
+                    offset = total;
+                }
+                total += locals[i].size();
+            }
+            std::copy(local.begin(), local.end(), next.begin() + offset);
+
+            auto [first, last] = runtime::split(total, threads_count, worker);
+            ranges[worker].next.store(first, memory_order_relaxed);
+            ranges[worker].last = last;
+
+            // Flag may be raised by a fast worker already in the next level, so
+            // the decision to stop is taken once for everybody
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait([&] {
+                    stop = cycle_found.load(memory_order_relaxed);
+                });
+            }
+
+            local.clear();
+            if (stop) {
+                return;
+            }
+            // Nothing expanded and nothing seeded
+            if (total == 0 && (!all_components || previous == 0)) {
+                return;
+            }
+        }
+    };
+
+    runtime::run_workers(threads_count, routine);
+
+    //! Witness
+    /** Parents are final once workers are joined. Trees merged before the conflicting edge
+        was resolved are connected through recorded links. */
+    if (witness && cycle_found.load()) {
+        vector<edge> forest = parent_forest(parents);
+        for (auto& worker_links : links) {
+            forest.insert(forest.end(), worker_links.begin(), worker_links.end());
+        }
+        *witness = trace_cycle(vertices_count, forest, conflict);
+    }
+
+    return cycle_found.load();
+}
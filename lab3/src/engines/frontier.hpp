@@ -0,0 +1,24 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run frontier bfs
+    /** Level-synchronous search from vertex 0. Workers expand chunks of the current frontier
+        into their own next-frontier buffers which are merged after every level; a worker that
+        ran out of its chunks steals remaining ones from others. A vertex is claimed by setting
+        its parent, so an edge to an already claimed vertex other than the parent closes a cycle.
+
+        If `all_components` is set every unvisited vertex may seed a new tree. Whenever the
+        frontier runs dry each worker seeds a batch of trees from its own slice of vertices, so
+        several components are searched at once. Trees meeting inside one component are merged
+        in a disjoint set forest: a second edge between the same pair of trees closes a cycle.
+
+        If `witness` is given, the found cycle is traced through parents and edges merging trees. */
+    bool run_frontier_bfs(graph::csr const& graph, size_t threads_count, bool all_components = false,
+                          cycle* witness = nullptr);
+}
@@ -0,0 +1,332 @@
+#include "engines/hybrid.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "concurrent/atomic_bitset.hpp"
+#include "concurrent/barrier.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    //! Chunks of the frontier owned by one worker
+    /** `next` is advanced by the owner and by thieves, `last` is written only between levels. */
+    struct alignas(64) chunk_range {
+        std::atomic<size_t> next = 0;
+        size_t              last = 0;
+    };
+
+    //! Vertices claimed by one worker during a level and sum of their degrees
+    struct alignas(64) level_sums {
+        size_t claimed = 0;
+        size_t degrees = 0;
+    };
+}
+
+bool engines::run_hybrid_bfs(graph::csr const& graph, size_t threads_count, bool all_components,
+                             cycle* witness) {
+    using std::atomic;
+    using std::vector;
+    using std::memory_order_relaxed;
+    using graph::vertex;
+    using graph::edge;
+    using graph::no_vertex;
+    using concurrent::atomic_bitset;
+    using runtime::instrumentation::counter;
+
+    auto constexpr chunk_size = size_t(256);
+
+    //! Direction switch
+    /** Bottom-up once edges of the frontier exceed 1 / alpha of the unexplored edges, top-down
+        again once the frontier has less than 1 / beta of the vertices (Beamer et al.).
+        Usual alpha is 14, it counts on top-down steps wasting most edges on visited vertices;
+        here the first such edge ends the search, so a bottom-up step pays only when it cannot
+        inspect more edges than the top-down one would. */
+    auto constexpr alpha = size_t(1);
+    auto constexpr beta  = size_t(24);
+
+    size_t const vertices_count = graph.vertices_count();
+    if (vertices_count == 0) {
+        return false;
+    }
+    threads_count = std::max<size_t>(threads_count, 1);
+
+    //! Search state
+    /** Every frontier is kept as a list. Frontier of a bottom-up step needs a bitmap too: it
+        is filled while the previous bottom-up step claims vertices, or from the list when
+        steps switch direction, and cleared word by word through the list after the step.
+        Component counters and the direction are written only in barrier completions. */
+    vector<atomic<vertex>> parents(vertices_count);
+    vector<vertex>         frontiers[2] = { vector<vertex>(vertices_count), vector<vertex>(vertices_count) };
+    atomic_bitset          bitmaps[2]   = { atomic_bitset(vertices_count), atomic_bitset(vertices_count) };
+    vector<vector<vertex>> locals(threads_count);
+    vector<chunk_range>    ranges(threads_count);
+    vector<level_sums>     sums(threads_count);
+    concurrent::barrier    level_barrier(threads_count);
+    atomic<bool>           cycle_found        = false;
+    edge                   conflict           = {};
+    bool                   counted            = false;
+    bool                   bottom_up          = false;
+    bool                   has_bitmap         = false;
+    bool                   stop               = false;
+    size_t                 frontier_size      = 0;
+    size_t                 next_root          = 0;
+    size_t                 component_vertices = 0;
+    size_t                 component_degrees  = 0;
+    size_t                 explored_degrees   = 0;
+
+    for (auto& parent : parents) {
+        parent.store(no_vertex, memory_order_relaxed);
+    }
+
+    //! Start component
+    /** Makes `root` the only vertex of the frontier with the given parity. */
+    auto start = [&](vertex root, size_t parity) -> void {
+        parents[root].store(root, memory_order_relaxed);
+        frontiers[parity][0] = root;
+        ranges[0].next.store(0, memory_order_relaxed);
+        ranges[0].last = 1;
+
+        frontier_size       = 1;
+        component_vertices  = 1;
+        component_degrees   = graph.degree(root);
+        explored_degrees   += graph.degree(root);
+        bottom_up           = false;
+        has_bitmap          = false;
+    };
+
+    //! Seed
+    /** Starts the next component from an unvisited vertex. Returns false if there is none. */
+    auto seed = [&](size_t parity) -> bool {
+        for (; next_root < vertices_count; ++next_root) {
+            if (parents[next_root].load(memory_order_relaxed) == no_vertex) {
+                start(vertex(next_root), parity);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    //! Take chunk
+    /** Returns first vertex of the taken chunk in `first` or false if `range` is exhausted. */
+    auto take = [](chunk_range& range, size_t* first) -> bool {
+        if (range.next.load(memory_order_relaxed) >= range.last) {
+            return false;
+        }
+        *first = range.next.fetch_add(chunk_size, memory_order_relaxed);
+        return *first < range.last;
+    };
+
+    //! Report cycle
+    /** Only the first edge closing a cycle is kept as the witness. */
+    auto report = [&](vertex u, vertex w) -> void {
+        if (!cycle_found.exchange(true, memory_order_relaxed)) {
+            conflict = { u, w };
+        }
+    };
+
+    //! Finish level
+    /** Runs in the barrier completion with sums of the level: judges a finished component,
+        seeds the next one and picks direction of the next step. */
+    auto finish_level = [&](size_t level) -> void {
+        size_t claimed = 0;
+        size_t degrees = 0;
+        for (auto const& sum : sums) {
+            claimed += sum.claimed;
+            degrees += sum.degrees;
+        }
+        component_vertices += claimed;
+        component_degrees  += degrees;
+        explored_degrees   += degrees;
+        frontier_size       = claimed;
+        has_bitmap          = bottom_up;
+
+        if (claimed == 0) {
+            if (component_degrees > 2 * (component_vertices - 1)) {
+                cycle_found.store(true, memory_order_relaxed);
+                counted = true;
+                stop    = true;
+                return;
+            }
+            stop = !all_components || !seed((level + 1) % 2);
+            return;
+        }
+
+        size_t const unexplored = graph.neighbours_count() - explored_degrees;
+        if (!bottom_up && degrees > unexplored / alpha) {
+            bottom_up = true;
+        } else if (bottom_up && claimed < vertices_count / beta) {
+            bottom_up = false;
+        }
+    };
+
+    //! Thread routine.
+    auto routine = [&](size_t worker) -> void {
+        auto& local = locals[worker];
+        auto& sum   = sums[worker];
+
+        for (size_t level = 0;; ++level) {
+            vector<vertex> const& frontier      = frontiers[level % 2];
+            vector<vertex>&       next          = frontiers[(level + 1) % 2];
+            atomic_bitset&        frontier_bits = bitmaps[level % 2];
+            atomic_bitset&        next_bits     = bitmaps[(level + 1) % 2];
+
+            sum = {};
+            auto visit = [&](vertex v) -> void {
+                local.push_back(v);
+                sum.degrees += graph.degree(v);
+                if (bottom_up) {
+                    next_bits.claim(v);
+                }
+            };
+
+            // Direction has just switched, the frontier exists only as a list
+            if (bottom_up && !has_bitmap) {
+                auto [first, last] = runtime::split(frontier_size, threads_count, worker);
+                for (size_t i = first; i < last; ++i) {
+                    frontier_bits.claim(frontier[i]);
+                }
+
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait([&] {
+                    has_bitmap = true;
+                });
+            }
+
+            if (bottom_up) {
+                //! Bottom-up step
+                /** Every unvisited vertex of own slice is claimed by its owner, so the parent
+                    is stored without a race. */
+                auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+                for (size_t v = first; v < last && !cycle_found.load(memory_order_relaxed); ++v) {
+                    if (parents[v].load(memory_order_relaxed) != no_vertex) {
+                        continue;
+                    }
+                    runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+
+                    for (auto it = graph.begin(vertex(v)); it != graph.end(vertex(v)); ++it) {
+                        runtime::instrumentation::add(worker, counter::EDGES_SCANNED, 1);
+                        if (frontier_bits.test(*it)) {
+                            parents[v].store(*it, memory_order_relaxed);
+                            visit(vertex(v));
+                            break;
+                        }
+                    }
+                }
+            } else {
+                //! Top-down step
+                /** Neighbour claimed from another edge or self-loop closes a cycle. */
+                auto expand = [&](size_t first, size_t last) -> void {
+                    for (size_t i = first; i < last; ++i) {
+                        vertex const current = frontier[i];
+                        vertex const from    = parents[current].load(memory_order_relaxed);
+                        runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+                        runtime::instrumentation::add(worker, counter::EDGES_SCANNED, graph.degree(current));
+
+                        for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                            vertex const neighbour = *it;
+                            if (neighbour == from && neighbour != current) {
+                                continue;
+                            }
+
+                            vertex expected = no_vertex;
+                            if (parents[neighbour].compare_exchange_strong(expected, current, memory_order_relaxed)) {
+                                visit(neighbour);
+                                continue;
+                            }
+                            report(current, neighbour);
+                            return;
+                        }
+                    }
+                };
+
+                // Own chunks first, then steal from others
+                for (size_t offset = 0; offset < threads_count; ++offset) {
+                    auto& range = ranges[(worker + offset) % threads_count];
+
+                    size_t first;
+                    while (!cycle_found.load(memory_order_relaxed) && take(range, &first)) {
+                        expand(first, std::min(first + chunk_size, range.last));
+                    }
+                }
+            }
+
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait();
+            }
+
+            //! Merge local buffers
+            /** Each worker copies its buffer to the offset given by sizes of preceding buffers,
+                prepares own range of the next level and clears own part of the old bitmap. */
+            size_t offset = 0;
+            size_t total  = 0;
+            for (size_t i = 0; i < threads_count; ++i) {
+                if (i == worker) {
+                    offset = total;
+                }
+                total += locals[i].size();
+            }
+            std::copy(local.begin(), local.end(), next.begin() + offset);
+            sum.claimed = local.size();
+
+            auto [first, last] = runtime::split(total, threads_count, worker);
+            ranges[worker].next.store(first, memory_order_relaxed);
+            ranges[worker].last = last;
+
+            if (has_bitmap) {
+                auto [clear_first, clear_last] = runtime::split(frontier_size, threads_count, worker);
+                for (size_t i = clear_first; i < clear_last; ++i) {
+                    frontier_bits.clear_word(frontier[i]);
+                }
+            }
+
+            // Next step is decided once for everybody
+            {
+                runtime::instrumentation::wait_timer timer(worker, counter::SYNC_WAIT_NS);
+                level_barrier.arrive_and_wait([&] {
+                    stop = cycle_found.load(memory_order_relaxed);
+                    if (!stop) {
+                        finish_level(level);
+                    }
+                });
+            }
+
+            local.clear();
+            if (stop) {
+                return;
+            }
+        }
+    };
+
+    if (all_components) {
+        seed(0);
+    } else {
+        start(0, 0);
+    }
+    runtime::run_workers(threads_count, routine);
+
+    //! Witness
+    /** Counted cycle has no known closing edge, so visited rows are scanned for a self-loop or
+        an edge which is not a tree edge. Only the last searched component is cyclic. */
+    if (witness && cycle_found.load()) {
+        for (size_t u = 0; counted && u < vertices_count; ++u) {
+            vertex const parent = parents[u].load(memory_order_relaxed);
+            if (parent == no_vertex) {
+                continue;
+            }
+            for (auto it = graph.begin(vertex(u)); it != graph.end(vertex(u)); ++it) {
+                if (*it == u || (*it != parent && parents[*it].load(memory_order_relaxed) != u)) {
+                    conflict = { vertex(u), *it };
+                    counted  = false;
+                    break;
+                }
+            }
+        }
+        *witness = trace_cycle(vertices_count, parent_forest(parents), conflict);
+    }
+
+    return cycle_found.load();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run hybrid bfs
+    /** Direction-optimizing level-synchronous search from vertex 0. Small frontiers are expanded
+        top-down as in `run_frontier_bfs`: vertices claim their neighbours, and an edge to an
+        already claimed vertex other than the parent closes a cycle. Once edges leaving the frontier
+        outnumber the unexplored ones, steps go bottom-up: every unvisited vertex
+        looks for a neighbour in the frontier bitmap and stops at the first one, so edges to
+        visited vertices are mostly never inspected. Steps go top-down again when the frontier
+        shrinks below a fraction of the vertices.
+
+        Bottom-up steps do not see every closing edge, so a finished component is also judged by
+        counting: it has a cycle iff the sum of degrees of its vertices exceeds 2 (V - 1), self-loop
+        counted once. If `all_components` is set, components are searched one after another.
+        If `witness` is given and the cycle was only counted, a closing edge is found by a scan
+        of the visited rows after the search. */
+    bool run_hybrid_bfs(graph::csr const& graph, size_t threads_count, bool all_components = false,
+                        cycle* witness = nullptr);
+}
@@ -0,0 +1,63 @@
+#include "engines/sequential.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+bool engines::run_sequential_dfs(graph::csr const& graph, bool all_components, cycle* witness) {
+    using std::pair;
+    using std::vector;
+    using graph::vertex;
+    using graph::no_vertex;
+
+    size_t const vertices_count = graph.vertices_count();
+
+    //! Search state
+    /** Stack keeps every vertex of the current path with the next neighbour to look at. */
+    vector<vertex>                       parents(vertices_count, no_vertex);
+    vector<pair<vertex, vertex const*>>  stack;
+
+    size_t const roots_end = all_components ? vertices_count : std::min<size_t>(vertices_count, 1);
+    for (size_t root = 0; root < roots_end; ++root) {
+        if (parents[root] != no_vertex) {
+            continue;
+        }
+        parents[root] = vertex(root);
+        stack.emplace_back(vertex(root), graph.begin(vertex(root)));
+
+        while (!stack.empty()) {
+            auto& [current, next] = stack.back();
+            if (next == graph.end(current)) {
+                stack.pop_back();
+                continue;
+            }
+
+            vertex const neighbour = *next++;
+            if (neighbour == parents[current] && neighbour != current) {
+                continue;
+            }
+            if (parents[neighbour] == no_vertex) {
+                parents[neighbour] = current;
+                stack.emplace_back(neighbour, graph.begin(neighbour));
+                continue;
+            }
+
+            // Self-loop or edge back to a vertex on the path
+            if (witness) {
+                size_t first = stack.size() - 1;
+                while (stack[first].first != neighbour) {
+                    --first;
+                }
+
+                witness->clear();
+                for (size_t i = first; i < stack.size(); ++i) {
+                    witness->push_back(stack[i].first);
+                }
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
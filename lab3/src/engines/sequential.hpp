@@ -0,0 +1,17 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run sequential dfs
+    /** Single-threaded iterative depth-first search from vertex 0, or from every unvisited vertex
+        if `all_components` is set. In an undirected search every edge other than the one to the
+        parent leads to a visited vertex only if it closes a cycle, and that vertex is then still
+        on the stack, so the witness is the top of the stack. No worker is started, which makes it
+        the fastest engine for small graphs. */
+    bool run_sequential_dfs(graph::csr const& graph, bool all_components = false, cycle* witness = nullptr);
+}
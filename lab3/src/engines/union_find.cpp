@@ -0,0 +1,79 @@
+#include "engines/union_find.hpp"
+
+/* stdlib: */
+#include <atomic>
+#include <algorithm>
+#include <vector>
+
+#include "concurrent/disjoint_sets.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/workers.hpp"
+
+bool engines::run_union_find(graph::csr const& graph, size_t threads_count, cycle* witness) {
+    using std::atomic;
+    using std::vector;
+    using std::memory_order_relaxed;
+    using graph::vertex;
+    using graph::edge;
+    using runtime::instrumentation::counter;
+
+    auto constexpr chunk_size = size_t(1024);
+
+    size_t const               vertices_count = graph.vertices_count();
+    concurrent::disjoint_sets  sets(vertices_count);
+    atomic<size_t>             next_chunk = 0;
+    atomic<bool>               cycle_found = false;
+    edge                       conflict    = {};
+    vector<vector<edge>>       links(witness ? threads_count : 0);
+
+    //! Thread routine.
+    /** Every undirected edge is stored twice in CSR, so only (u, w) with u <= w is united. */
+    auto routine = [&](size_t worker) -> void {
+        while (!cycle_found.load(memory_order_relaxed)) {
+            size_t const first = next_chunk.fetch_add(chunk_size, memory_order_relaxed);
+            if (first >= vertices_count) {
+                return;
+            }
+            size_t const last = std::min(first + chunk_size, vertices_count);
+
+            for (size_t u = first; u < last; ++u) {
+                if (cycle_found.load(memory_order_relaxed)) {
+                    return;
+                }
+                runtime::instrumentation::add(worker, counter::VERTICES_EXPANDED, 1);
+                runtime::instrumentation::add(worker, counter::EDGES_SCANNED, graph.degree(vertex(u)));
+
+                for (auto it = graph.begin(vertex(u)); it != graph.end(vertex(u)); ++it) {
+                    if (*it < u) {
+                        continue;
+                    }
+                    // Self-loop or edge inside one tree, the first one found is the witness
+                    if (*it == u || !sets.unite(vertex(u), *it)) {
+                        if (!cycle_found.exchange(true, memory_order_relaxed)) {
+                            conflict = { vertex(u), *it };
+                        }
+                        return;
+                    }
+                    if (witness) {
+                        links[worker].push_back({ vertex(u), *it });
+                    }
+                }
+            }
+        }
+    };
+
+    runtime::run_workers(threads_count, routine);
+
+    //! Witness
+    /** Every successful link is recorded right after it is made, so once workers are joined
+        the links connect both ends of the conflicting edge. */
+    if (witness && cycle_found.load()) {
+        vector<edge> forest;
+        for (auto& worker_links : links) {
+            forest.insert(forest.end(), worker_links.begin(), worker_links.end());
+        }
+        *witness = trace_cycle(vertices_count, forest, conflict);
+    }
+
+    return cycle_found.load();
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+
+#include "graph/csr.hpp"
+#include "engines/witness.hpp"
+
+namespace engines {
+    //! run union find
+    /** Searches for a cycle in every component of the graph with a concurrent disjoint set forest.
+        Each edge is united once; an edge joining two vertices of the same set closes a cycle.
+        Workers pick chunks of vertices dynamically and stop as soon as any of them finds a cycle.
+        If `witness` is given, edges that linked two sets are recorded and the found cycle is
+        traced through them. */
+    bool run_union_find(graph::csr const& graph, size_t threads_count, cycle* witness = nullptr);
+}
@@ -0,0 +1,44 @@
+#include "engines/witness.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <stdexcept>
+
+engines::cycle engines::trace_cycle(size_t vertices_count, std::vector<graph::edge> const& forest, graph::edge closing) {
+    using std::vector;
+    using graph::vertex;
+    using graph::no_vertex;
+
+    if (closing.u == closing.v) {
+        return { closing.u };
+    }
+
+    //! Path between ends of the closing edge
+    /** Forest is acyclic, so plain search from `u` finds the only path to `v`. */
+    graph::csr const tree = graph::build_csr(vertices_count, forest, 1);
+
+    vector<vertex> previous(vertices_count, no_vertex);
+    vector<vertex> queue   = { closing.u };
+    previous[closing.u] = closing.u;
+    for (size_t i = 0; i < queue.size() && previous[closing.v] == no_vertex; ++i) {
+        vertex const current = queue[i];
+        for (auto it = tree.begin(current); it != tree.end(current); ++it) {
+            if (previous[*it] == no_vertex) {
+                previous[*it] = current;
+                queue.push_back(*it);
+            }
+        }
+    }
+    if (previous[closing.v] == no_vertex) {
+        throw std::logic_error("ends of the closing edge are not connected in the search forest");
+    }
+
+    cycle result;
+    for (vertex v = closing.v; v != closing.u; v = previous[v]) {
+        result.push_back(v);
+    }
+    result.push_back(closing.u);
+    std::reverse(result.begin(), result.end());
+
+    return result;
+}
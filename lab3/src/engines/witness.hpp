@@ -0,0 +1,35 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <vector>
+
+#include "graph/csr.hpp"
+
+namespace engines {
+    //! Cycle witness
+    /** Vertices of one simple cycle in order of traversal, last vertex is adjacent to the first.
+        Self-loop is a cycle of one vertex. */
+    using cycle = std::vector<graph::vertex>;
+
+    //! trace cycle
+    /** Returns the cycle closed by edge `closing` in the acyclic `forest` recorded during search.
+        `closing` itself must not belong to the forest and its ends must be connected in it.
+        Runs sequentially after the search is over, so engines record only what they have anyway. */
+    cycle trace_cycle(size_t vertices_count, std::vector<graph::edge> const& forest, graph::edge closing);
+
+    //! parent forest
+    /** Returns tree edges (v, parents[v]) of every claimed vertex that is not a root.
+        Roots are their own parents, unclaimed vertices have `graph::no_vertex`. */
+    template<typename parents_type>
+    std::vector<graph::edge> parent_forest(parents_type const& parents) {
+        std::vector<graph::edge> forest;
+        for (size_t v = 0; v < parents.size(); ++v) {
+            graph::vertex const parent = parents[v];
+            if (parent != graph::no_vertex && parent != v) {
+                forest.push_back({ graph::vertex(v), parent });
+            }
+        }
+        return forest;
+    }
+}
@@ -0,0 +1,232 @@
+#include "graph/binary.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "runtime/mapped_file.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    using std::uint32_t;
+    using std::uint64_t;
+
+    char constexpr magic[8]     = { 'L', 'A', 'B', '3', 'C', 'S', 'R', '\0' };
+    auto constexpr version      = uint32_t(2);
+    auto constexpr block_size   = size_t(1) << 20;
+    auto constexpr fnv_offset   = uint64_t(14695981039346656037ull);
+    auto constexpr fnv_prime    = uint64_t(1099511628211ull);
+    auto constexpr directed_bit = uint64_t(1);
+
+    struct header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t vertices_count;
+        uint64_t neighbours_count;
+        uint64_t payload_checksum;
+        uint64_t header_checksum;
+        uint64_t flags;
+        uint64_t reserved;
+    };
+    static_assert(sizeof(header) == 64, "binary graph header must be 64 bytes");
+
+    //! Arrays are used in place, so the host must share the file byte order
+    bool little_endian() noexcept {
+        uint32_t const probe = 1;
+        char           first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    uint64_t hash_bytes(char const* data, size_t size, uint64_t hash) noexcept {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * fnv_prime;
+        }
+        for (; i < size; ++i) {
+            hash = (hash ^ uint8_t(data[i])) * fnv_prime;
+        }
+        return hash;
+    }
+
+    //! checksum
+    /** Hashes fixed blocks in parallel, then chains block hashes and the size. */
+    uint64_t checksum(void const* data, size_t size, size_t threads_count) {
+        auto const bytes  = static_cast<char const*>(data);
+        size_t const blocks = (size + block_size - 1) / block_size;
+
+        std::vector<uint64_t> hashes(blocks);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(blocks, threads_count, worker);
+            for (size_t b = first; b < last; ++b) {
+                size_t const offset = b * block_size;
+                hashes[b] = hash_bytes(bytes + offset, std::min(block_size, size - offset), fnv_offset);
+            }
+        });
+
+        uint64_t hash = fnv_offset;
+        for (uint64_t block_hash : hashes) {
+            hash = (hash ^ block_hash) * fnv_prime;
+        }
+        return (hash ^ uint64_t(size)) * fnv_prime;
+    }
+
+    uint64_t payload_checksum(graph::edge_index const* offsets, size_t vertices_count,
+                              graph::vertex const* neighbours, size_t neighbours_count, size_t threads_count) {
+        uint64_t const first  = checksum(offsets, (vertices_count + 1) * sizeof(uint64_t), threads_count);
+        uint64_t const second = checksum(neighbours, neighbours_count * sizeof(uint32_t), threads_count);
+        return ((fnv_offset ^ first) * fnv_prime ^ second) * fnv_prime;
+    }
+
+    //! valid offsets
+    /** Checks that offsets never decrease, with the first and the last one checked by the caller
+        this keeps every row inside the neighbours array. */
+    bool valid_offsets(graph::edge_index const* offsets, size_t vertices_count, size_t threads_count) {
+        std::vector<char> valid(threads_count, 1);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+            for (size_t u = first; u < last; ++u) {
+                if (offsets[u] > offsets[u + 1]) {
+                    valid[worker] = 0;
+                    return;
+                }
+            }
+        });
+        return std::all_of(valid.begin(), valid.end(), [](char ok) { return ok != 0; });
+    }
+
+    //! valid neighbours
+    /** Checks that every neighbour is a vertex of the graph. Checksum only proves that
+        the array is the one written, not that it is sane. */
+    bool valid_neighbours(graph::vertex const* neighbours, size_t neighbours_count, size_t vertices_count,
+                          size_t threads_count) {
+        std::vector<char> valid(threads_count, 1);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(neighbours_count, threads_count, worker);
+            valid[worker] = std::all_of(neighbours + first, neighbours + last,
+                                        [&](graph::vertex v) { return v < vertices_count; });
+        });
+        return std::all_of(valid.begin(), valid.end(), [](char ok) { return ok != 0; });
+    }
+
+    uint64_t header_checksum(header const& head) noexcept {
+        header copy = head;
+        copy.header_checksum = 0;
+        return hash_bytes(reinterpret_cast<char const*>(&copy), sizeof(copy), fnv_offset);
+    }
+}
+
+bool graph::is_binary_csr(std::string const& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    char prefix[sizeof(magic)] = {};
+    file.read(prefix, sizeof(prefix));
+    return file.gcount() == sizeof(prefix) && std::memcmp(prefix, magic, sizeof(magic)) == 0;
+}
+
+void graph::save_binary_csr(csr const& graph, std::string const& path, size_t threads_count, bool directed) {
+    using std::runtime_error;
+
+    static_assert(sizeof(edge_index) == sizeof(uint64_t), "offsets are stored as 64-bit words");
+    static_assert(sizeof(vertex) == sizeof(uint32_t), "neighbours are stored as 32-bit words");
+    if (!little_endian()) {
+        throw runtime_error("binary graph format requires little-endian host");
+    }
+
+    size_t const vertices_count   = graph.vertices_count();
+    size_t const neighbours_count = graph.neighbours_count();
+
+    // Graph without vertices still has the leading zero offset
+    edge_index const empty   = 0;
+    edge_index const* offsets = vertices_count == 0 ? &empty : graph.offsets();
+
+    header head = {};
+    std::memcpy(head.magic, magic, sizeof(magic));
+    head.version          = version;
+    head.header_size      = sizeof(header);
+    head.vertices_count   = vertices_count;
+    head.neighbours_count = neighbours_count;
+    head.flags            = directed ? directed_bit : 0;
+    head.payload_checksum = payload_checksum(offsets, vertices_count, graph.neighbours(), neighbours_count, threads_count);
+    head.header_checksum  = header_checksum(head);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char const*>(&head), sizeof(head));
+    file.write(reinterpret_cast<char const*>(offsets), std::streamsize((vertices_count + 1) * sizeof(edge_index)));
+    file.write(reinterpret_cast<char const*>(graph.neighbours()), std::streamsize(neighbours_count * sizeof(vertex)));
+    file.close();
+    if (!file) {
+        throw runtime_error("can not write '" + path + "'");
+    }
+}
+
+graph::csr graph::map_binary_csr(std::string const& path, bool verify, size_t threads_count, bool directed) {
+    using std::runtime_error;
+
+    if (!little_endian()) {
+        throw runtime_error("binary graph format requires little-endian host");
+    }
+
+    auto const file = std::make_shared<runtime::mapped_file>(path, runtime::access_pattern::NORMAL);
+    if (file->size() < sizeof(header)) {
+        throw runtime_error("'" + path + "' is not a binary graph");
+    }
+
+    header head;
+    std::memcpy(&head, file->data(), sizeof(head));
+    if (std::memcmp(head.magic, magic, sizeof(magic)) != 0 || head.header_size != sizeof(header)) {
+        throw runtime_error("'" + path + "' is not a binary graph");
+    }
+    if (head.version != version) {
+        throw runtime_error("unsupported binary graph version " + std::to_string(head.version)
+                            + ", convert the graph again");
+    }
+    if (head.header_checksum != header_checksum(head)) {
+        throw runtime_error("binary graph header is damaged");
+    }
+    if (((head.flags & directed_bit) != 0) != directed) {
+        throw runtime_error(directed ? "binary graph is undirected" : "binary graph is directed, use --directed");
+    }
+
+    //! Layout
+    /** Sizes are checked before multiplication so a damaged count can not wrap around. */
+    uint64_t const vertices_count   = head.vertices_count;
+    uint64_t const neighbours_count = head.neighbours_count;
+    if (vertices_count >= uint64_t(no_vertex) || neighbours_count > file->size() / sizeof(vertex)
+        || vertices_count + 1 > file->size() / sizeof(edge_index)) {
+        throw runtime_error("binary graph size does not match its header");
+    }
+
+    size_t const offsets_bytes    = size_t(vertices_count + 1) * sizeof(edge_index);
+    size_t const neighbours_bytes = size_t(neighbours_count) * sizeof(vertex);
+    if (sizeof(header) + offsets_bytes + neighbours_bytes != file->size()) {
+        throw runtime_error("binary graph size does not match its header");
+    }
+
+    auto const offsets    = reinterpret_cast<edge_index const*>(file->data() + sizeof(header));
+    auto const neighbours = reinterpret_cast<vertex const*>(file->data() + sizeof(header) + offsets_bytes);
+    if (offsets[0] != 0 || offsets[vertices_count] != neighbours_count
+        || !valid_offsets(offsets, size_t(vertices_count), threads_count)) {
+        throw runtime_error("binary graph offsets are damaged");
+    }
+    if (verify) {
+        uint64_t const actual = payload_checksum(offsets, size_t(vertices_count), neighbours,
+                                                 size_t(neighbours_count), threads_count);
+        if (actual != head.payload_checksum) {
+            throw runtime_error("binary graph is damaged, checksum mismatch");
+        }
+        if (!valid_neighbours(neighbours, size_t(neighbours_count), size_t(vertices_count), threads_count)) {
+            throw runtime_error("binary graph is damaged, neighbours are out of range");
+        }
+    }
+
+    return csr(file, offsets, neighbours, size_t(vertices_count));
+}
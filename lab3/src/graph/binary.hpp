@@ -0,0 +1,46 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <string>
+
+#include "graph/csr.hpp"
+
+namespace graph {
+    //! Binary graph file
+    /** Little-endian image of `csr` that is used in place once mapped:
+
+            offset  size         field
+            0       8            magic "LAB3CSR\0"
+            8       4            format version, 2
+            12      4            header size, 64
+            16      8            vertices count V
+            24      8            neighbours count N
+            32      8            checksum of the arrays
+            40      8            checksum of the header with this field zeroed
+            48      8            flags, bit 0 is set for a directed graph
+            56      8            reserved, zero
+            64      8 * (V + 1)  offsets
+            ...     4 * N        neighbours
+
+        Checksums are FNV-1a over 64-bit words of 1 MB blocks chained in order,
+        so they are computed in parallel but do not depend on threads count. */
+
+    //! is binary csr
+    /** Returns true if file at `path` starts with the binary graph magic. */
+    bool is_binary_csr(std::string const& path);
+
+    //! save binary csr
+    /** Writes graph to `path`, `directed` marks it as built by `build_directed_csr`.
+        Throws `std::runtime_error` if the file can not be written. */
+    void save_binary_csr(csr const& graph, std::string const& path, size_t threads_count, bool directed = false);
+
+    //! map binary csr
+    /** Maps file at `path` and returns graph viewing the mapping, nothing is parsed or copied
+        and pages are shared with other processes through the page cache. Header and offsets
+        are always checked; arrays are checked against their checksum and neighbours for being
+        in range only if `verify` is set, since that reads the whole file. Throws
+        `std::runtime_error` on a malformed or damaged file or if the file is not `directed`
+        as expected. */
+    csr map_binary_csr(std::string const& path, bool verify, size_t threads_count, bool directed = false);
+}
@@ -0,0 +1,34 @@
+#include "graph/bit_matrix.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <stdexcept>
+
+#include "runtime/workers.hpp"
+
+graph::bit_matrix::bit_matrix(csr const& graph, size_t threads_count) {
+    size_t const vertices_count = graph.vertices_count();
+    if (vertices_count > max_vertices) {
+        throw std::runtime_error("graph is too large for the adjacency matrix");
+    }
+
+    size_t const lines_per_row = (vertices_count + bitmap::bits_per_word * bitmap::words_per_line - 1)
+                               / (bitmap::bits_per_word * bitmap::words_per_line);
+
+    vertices_count_ = vertices_count;
+    words_per_row_  = lines_per_row * bitmap::words_per_line;
+    bits_           = bitmap(vertices_count * words_per_row_);
+
+    //! Fill rows
+    /** Every row is written only by the worker owning its vertex. */
+    threads_count = std::max<size_t>(threads_count, 1);
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t v = first; v < last; ++v) {
+            word* const row = bits_.words() + v * words_per_row_;
+            for (auto it = graph.begin(vertex(v)); it != graph.end(vertex(v)); ++it) {
+                row[*it / bitmap::bits_per_word] |= word(1) << (*it % bitmap::bits_per_word);
+            }
+        }
+    });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graph/csr.hpp"
+
+namespace graph {
+    //! Cache line of bitmap words
+    struct alignas(64) bit_line {
+        std::uint64_t words[8];
+    };
+
+    //! Bitmap of whole cache lines
+    /** Words are zeroed and aligned to cache lines, so any four of them starting at a multiple
+        of four can be read by one 256-bit load. */
+    class bitmap {
+        std::vector<bit_line> lines_;
+
+    public:
+        using word = std::uint64_t;
+
+        static auto constexpr bits_per_word  = size_t(64);
+        static auto constexpr words_per_line = sizeof(bit_line) / sizeof(word);
+
+        bitmap() = default;
+
+        explicit bitmap(size_t words_count)
+            : lines_((words_count + words_per_line - 1) / words_per_line, bit_line{}) {}
+
+        word* words() noexcept {
+            return reinterpret_cast<word*>(lines_.data());
+        }
+
+        word const* words() const noexcept {
+            return reinterpret_cast<word const*>(lines_.data());
+        }
+    };
+
+    //! Dense adjacency matrix
+    /** Row of vertex `v` is a bitmap of its neighbours. Rows are padded to whole cache lines,
+        so every row starts aligned and the matrix takes V^2 / 8 bytes whatever the edges count. */
+    class bit_matrix {
+        bitmap bits_;
+        size_t vertices_count_ = 0;
+        size_t words_per_row_  = 0;
+
+    public:
+        using word = bitmap::word;
+
+        //! Largest graph the matrix is built for, it takes 512 MB
+        static auto constexpr max_vertices = size_t(1) << 16;
+
+        //! bit matrix
+        /** Builds the matrix of `graph` filling rows by `threads_count` workers.
+            Throws `std::runtime_error` if the graph has more than `max_vertices` vertices. */
+        bit_matrix(csr const& graph, size_t threads_count);
+
+        size_t vertices_count() const noexcept {
+            return vertices_count_;
+        }
+
+        //! words per row
+        /** Returns row length, a multiple of `bitmap::words_per_line`. Bits past the last
+            vertex are zero. */
+        size_t words_per_row() const noexcept {
+            return words_per_row_;
+        }
+
+        word const* row(vertex v) const noexcept {
+            return bits_.words() + size_t(v) * words_per_row_;
+        }
+    };
+}
@@ -0,0 +1,236 @@
+#include "graph/csr.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#include "runtime/workers.hpp"
+
+namespace {
+    using graph::edge_index;
+
+    //! exclusive scan
+    /** Replaces `values[i]` by the sum of `values[0..i)` and returns total sum.
+        Blocks are summed by workers, then block sums are scanned sequentially. */
+    template<typename value_type>
+    edge_index exclusive_scan(std::vector<value_type>& values, size_t threads_count) {
+        using std::vector;
+
+        vector<edge_index> block_sums(threads_count + 1, 0);
+
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(values.size(), threads_count, worker);
+
+            edge_index sum = 0;
+            for (size_t i = first; i < last; ++i) {
+                sum += values[i];
+            }
+            block_sums[worker + 1] = sum;
+        });
+
+        for (size_t i = 0; i < threads_count; ++i) {
+            block_sums[i + 1] += block_sums[i];
+        }
+
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(values.size(), threads_count, worker);
+
+            edge_index sum = block_sums[worker];
+            for (size_t i = first; i < last; ++i) {
+                edge_index const value = values[i];
+                values[i] = sum;
+                sum += value;
+            }
+        });
+
+        return block_sums[threads_count];
+    }
+}
+
+namespace {
+    //! Arrays of a built graph
+    struct csr_arrays {
+        std::vector<graph::edge_index> offsets;
+        std::vector<graph::vertex>     neighbours;
+    };
+}
+
+graph::csr::csr(std::vector<edge_index> offsets, std::vector<vertex> neighbours) {
+    auto arrays = std::make_shared<csr_arrays>(csr_arrays{ std::move(offsets), std::move(neighbours) });
+
+    offsets_        = arrays->offsets.data();
+    neighbours_     = arrays->neighbours.data();
+    vertices_count_ = arrays->offsets.empty() ? 0 : arrays->offsets.size() - 1;
+    storage_        = std::move(arrays);
+}
+
+namespace {
+    //! Rows an edge (u, v) is stored in
+    enum class orientation {
+        BOTH,      ///< v in row of u and u in row of v
+        FORWARD,   ///< v in row of u
+        BACKWARD,  ///< u in row of v
+    };
+
+    //! sort and compact
+    /** Sorts rows of `scattered` given by `offsets`, removes duplicates and returns the graph. */
+    graph::csr sort_and_compact(std::vector<graph::vertex>& scattered, std::vector<edge_index> const& offsets,
+                                size_t threads_count) {
+        using std::vector;
+        using graph::vertex;
+
+        size_t const vertices_count = offsets.size() - 1;
+
+        //! Sort rows and remove duplicates
+        /** `unique` keeps number of distinct neighbours in each row. */
+        vector<edge_index> unique(vertices_count + 1, 0);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+            for (size_t v = first; v < last; ++v) {
+                auto const row_begin = scattered.begin() + offsets[v];
+                auto const row_end   = scattered.begin() + offsets[v + 1];
+
+                std::sort(row_begin, row_end);
+                unique[v] = edge_index(std::unique(row_begin, row_end) - row_begin);
+            }
+        });
+
+        edge_index const unique_total = exclusive_scan(unique, threads_count);
+
+        //! Compact rows
+        vector<vertex> neighbours(unique_total);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+            for (size_t v = first; v < last; ++v) {
+                auto const row_begin = scattered.begin() + offsets[v];
+                auto const row_size  = unique[v + 1] - unique[v];
+
+                std::copy(row_begin, row_begin + row_size, neighbours.begin() + unique[v]);
+            }
+        });
+
+        return graph::csr(std::move(unique), std::move(neighbours));
+    }
+
+    //! build
+    /** Builds CSR graph storing every edge in rows chosen by `rows`. */
+    graph::csr build(size_t vertices_count, std::vector<graph::edge> const& edges, size_t threads_count,
+                     orientation rows) {
+        using std::vector;
+        using std::atomic;
+        using std::runtime_error;
+        using std::memory_order_relaxed;
+        using graph::vertex;
+
+        threads_count = std::max<size_t>(threads_count, 1);
+
+        bool const forward  = rows != orientation::BACKWARD;
+        bool const backward = rows != orientation::FORWARD;
+
+        //! Count degrees
+        /** Self-loop (v, v) is stored once in the row of `v`. */
+        vector<atomic<edge_index>> cursors(vertices_count);
+        atomic<bool>               out_of_range = false;
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(edges.size(), threads_count, worker);
+            for (size_t i = first; i < last; ++i) {
+                if (edges[i].u >= vertices_count || edges[i].v >= vertices_count) {
+                    out_of_range.store(true, memory_order_relaxed);
+                    return;
+                }
+                if (forward) {
+                    cursors[edges[i].u].fetch_add(1, memory_order_relaxed);
+                }
+                if (backward && (!forward || edges[i].u != edges[i].v)) {
+                    cursors[edges[i].v].fetch_add(1, memory_order_relaxed);
+                }
+            }
+        });
+
+        if (out_of_range) {
+            throw runtime_error("vertex index is out of range");
+        }
+
+        vector<edge_index> offsets(vertices_count + 1, 0);
+        for (size_t v = 0; v < vertices_count; ++v) {
+            offsets[v] = cursors[v].load(memory_order_relaxed);
+        }
+        edge_index const total = exclusive_scan(offsets, threads_count);
+
+        //! Scatter edges into rows
+        /** Each endpoint reserves its slot with an atomic increment of the row cursor. */
+        for (size_t v = 0; v < vertices_count; ++v) {
+            cursors[v].store(offsets[v], memory_order_relaxed);
+        }
+
+        vector<vertex> scattered(total);
+        runtime::run_workers(threads_count, [&](size_t worker) {
+            auto [first, last] = runtime::split(edges.size(), threads_count, worker);
+            for (size_t i = first; i < last; ++i) {
+                auto const [u, v] = edges[i];
+                if (forward) {
+                    scattered[cursors[u].fetch_add(1, memory_order_relaxed)] = v;
+                }
+                if (backward && (!forward || u != v)) {
+                    scattered[cursors[v].fetch_add(1, memory_order_relaxed)] = u;
+                }
+            }
+        });
+
+        return sort_and_compact(scattered, offsets, threads_count);
+    }
+}
+
+graph::csr graph::build_csr(size_t vertices_count, std::vector<edge> const& edges, size_t threads_count) {
+    return build(vertices_count, edges, threads_count, orientation::BOTH);
+}
+
+graph::csr graph::build_directed_csr(size_t vertices_count, std::vector<edge> const& edges, size_t threads_count) {
+    return build(vertices_count, edges, threads_count, orientation::FORWARD);
+}
+
+graph::csr graph::transpose(csr const& graph, size_t threads_count) {
+    using std::vector;
+    using std::atomic;
+    using std::memory_order_relaxed;
+
+    threads_count = std::max<size_t>(threads_count, 1);
+
+    size_t const vertices_count = graph.vertices_count();
+
+    //! Count in-degrees
+    vector<atomic<edge_index>> cursors(vertices_count);
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t u = first; u < last; ++u) {
+            for (auto it = graph.begin(vertex(u)); it != graph.end(vertex(u)); ++it) {
+                cursors[*it].fetch_add(1, memory_order_relaxed);
+            }
+        }
+    });
+
+    vector<edge_index> offsets(vertices_count + 1, 0);
+    for (size_t v = 0; v < vertices_count; ++v) {
+        offsets[v] = cursors[v].load(memory_order_relaxed);
+    }
+    edge_index const total = exclusive_scan(offsets, threads_count);
+
+    //! Scatter reversed edges into rows
+    for (size_t v = 0; v < vertices_count; ++v) {
+        cursors[v].store(offsets[v], memory_order_relaxed);
+    }
+
+    vector<vertex> scattered(total);
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t u = first; u < last; ++u) {
+            for (auto it = graph.begin(vertex(u)); it != graph.end(vertex(u)); ++it) {
+                scattered[cursors[*it].fetch_add(1, memory_order_relaxed)] = vertex(u);
+            }
+        }
+    });
+
+    return sort_and_compact(scattered, offsets, threads_count);
+}
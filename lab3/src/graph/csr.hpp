@@ -0,0 +1,96 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace graph {
+    typedef std::uint32_t vertex;
+    typedef std::size_t   edge_index;
+
+    auto constexpr no_vertex = std::numeric_limits<vertex>::max();
+
+    //! Edge of the input graph
+    struct edge {
+        vertex u;
+        vertex v;
+    };
+
+    //! Compressed sparse row graph
+    /** Neighbours of vertex `v` are stored in `neighbours[offsets[v]]..neighbours[offsets[v + 1]]`
+        sorted and without duplicates, so memory usage is O(V + E).
+        Every undirected edge is stored twice: once in each of its endpoints; directed edge
+        is stored only in the row of its tail.
+
+        Arrays are read-only views into `storage`, which either owns built vectors or is a mapped
+        file, so a graph is shared by copies and can be used straight from the page cache. */
+    class csr {
+        std::shared_ptr<void const> storage_;
+        edge_index const*           offsets_        = nullptr;
+        vertex const*               neighbours_     = nullptr;
+        size_t                      vertices_count_ = 0;
+
+    public:
+        csr() = default;
+
+        //! Graph owning its arrays, `offsets` has V + 1 items
+        csr(std::vector<edge_index> offsets, std::vector<vertex> neighbours);
+
+        //! Graph viewing arrays kept alive by `storage`
+        csr(std::shared_ptr<void const> storage, edge_index const* offsets, vertex const* neighbours,
+            size_t vertices_count) noexcept
+            : storage_(std::move(storage))
+            , offsets_(offsets)
+            , neighbours_(neighbours)
+            , vertices_count_(vertices_count) {}
+
+        size_t vertices_count() const noexcept {
+            return vertices_count_;
+        }
+
+        //! neighbours count
+        /** Returns length of the neighbours array: twice the edges plus self-loops. */
+        size_t neighbours_count() const noexcept {
+            return vertices_count_ == 0 ? 0 : size_t(offsets_[vertices_count_]);
+        }
+
+        edge_index const* offsets() const noexcept {
+            return offsets_;
+        }
+
+        vertex const* neighbours() const noexcept {
+            return neighbours_;
+        }
+
+        size_t degree(vertex v) const noexcept {
+            return offsets_[v + 1] - offsets_[v];
+        }
+
+        vertex const* begin(vertex v) const noexcept {
+            return neighbours_ + offsets_[v];
+        }
+
+        vertex const* end(vertex v) const noexcept {
+            return neighbours_ + offsets_[v + 1];
+        }
+    };
+
+    //! build csr
+    /** Builds undirected CSR graph from the edge list using `threads_count` workers.
+        Duplicated edges are merged, so input may contain both (u, v) and (v, u).
+        Throws `std::runtime_error` if some edge refers to a vertex out of range. */
+    csr build_csr(size_t vertices_count, std::vector<edge> const& edges, size_t threads_count);
+
+    //! build directed csr
+    /** Builds directed CSR graph: row of `u` keeps heads of edges (u, v) leaving it.
+        Duplicated edges are merged, (u, v) and (v, u) are different edges.
+        Throws `std::runtime_error` if some edge refers to a vertex out of range. */
+    csr build_directed_csr(size_t vertices_count, std::vector<edge> const& edges, size_t threads_count);
+
+    //! transpose
+    /** Returns graph with every edge reversed: row of `v` keeps tails of edges entering it. */
+    csr transpose(csr const& graph, size_t threads_count);
+}
@@ -0,0 +1,178 @@
+#include "graph/dynamic_graph.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    bool contains(std::vector<graph::vertex> const& list, graph::vertex v) noexcept {
+        return std::find(list.begin(), list.end(), v) != list.end();
+    }
+
+    //! Erase `v` from the unordered list, returns false if it is absent
+    bool erase(std::vector<graph::vertex>& list, graph::vertex v) noexcept {
+        auto const it = std::find(list.begin(), list.end(), v);
+        if (it == list.end()) {
+            return false;
+        }
+        *it = list.back();
+        list.pop_back();
+        return true;
+    }
+}
+
+graph::dynamic_graph::dynamic_graph(csr const& graph)
+    : forest_(graph.vertices_count())
+    , tree_(graph.vertices_count())
+    , non_tree_(graph.vertices_count())
+    , stamps_(graph.vertices_count(), 0) {
+    using std::vector;
+
+    size_t const vertices_count = graph.vertices_count();
+
+    //! Initial spanning forest
+    /** Search from every unvisited vertex; edges other than the ones to parents become
+        non-tree edges. Each of them is seen from both ends, only the end with smaller index
+        takes it. */
+    vector<vertex> parents(vertices_count, no_vertex);
+    vector<vertex> queue;
+    for (size_t root = 0; root < vertices_count; ++root) {
+        if (parents[root] != no_vertex) {
+            continue;
+        }
+        parents[root] = vertex(root);
+        queue.assign(1, vertex(root));
+
+        for (size_t i = 0; i < queue.size(); ++i) {
+            vertex const current = queue[i];
+            for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                if (parents[*it] == no_vertex) {
+                    parents[*it] = current;
+                    queue.push_back(*it);
+
+                    forest_.link(*it, current);
+                    tree_[current].push_back(*it);
+                    tree_[*it].push_back(current);
+                } else if (*it == current || (current < *it && parents[*it] != current && parents[current] != *it)) {
+                    non_tree_[current].push_back(*it);
+                    if (*it != current) {
+                        non_tree_[*it].push_back(current);
+                    }
+                    ++non_tree_edges_;
+                }
+            }
+        }
+    }
+}
+
+void graph::dynamic_graph::check(vertex u, vertex v) const {
+    if (u >= vertices_count() || v >= vertices_count()) {
+        throw std::runtime_error("vertex index is out of range");
+    }
+}
+
+bool graph::dynamic_graph::add(vertex u, vertex v) {
+    check(u, v);
+
+    // Look up the edge from the end with fewer neighbours
+    auto const degree = [this](vertex w) { return tree_[w].size() + non_tree_[w].size(); };
+    if (degree(v) < degree(u)) {
+        std::swap(u, v);
+    }
+    if (contains(tree_[u], v) || contains(non_tree_[u], v)) {
+        return false;
+    }
+
+    if (u != v && !forest_.connected(u, v)) {
+        forest_.link(u, v);
+        tree_[u].push_back(v);
+        tree_[v].push_back(u);
+        return true;
+    }
+
+    non_tree_[u].push_back(v);
+    if (u != v) {
+        non_tree_[v].push_back(u);
+    }
+    ++non_tree_edges_;
+
+    return true;
+}
+
+bool graph::dynamic_graph::remove(vertex u, vertex v) {
+    check(u, v);
+
+    if (erase(non_tree_[u], v)) {
+        if (u != v) {
+            erase(non_tree_[v], u);
+        }
+        --non_tree_edges_;
+        return true;
+    }
+    if (!erase(tree_[u], v)) {
+        return false;
+    }
+    erase(tree_[v], u);
+    forest_.cut(u, v);
+
+    reconnect(u, v);
+    return true;
+}
+
+//! reconnect
+/** Looks for a non-tree edge joining the trees of `u` and `v` just split by a deletion
+    and turns it into a tree edge. Returns false if the trees stay apart. */
+bool graph::dynamic_graph::reconnect(vertex u, vertex v) {
+    stamp_ += 2;
+
+    //! Walk both halves in turn
+    /** Each step visits one more vertex of every half, so the walk stops after the smaller half
+        is complete and never costs more than twice its size. */
+    vertex const starts[2] = { u, v };
+    size_t       heads[2]  = { 0, 0 };
+    for (int side = 0; side < 2; ++side) {
+        sides_[side].assign(1, starts[side]);
+        stamps_[starts[side]] = stamp_ + side;
+    }
+
+    int smaller = -1;
+    while (smaller < 0) {
+        for (int side = 0; side < 2 && smaller < 0; ++side) {
+            auto& half = sides_[side];
+            if (heads[side] == half.size()) {
+                smaller = side;
+                break;
+            }
+
+            vertex const current = half[heads[side]++];
+            for (vertex neighbour : tree_[current]) {
+                if (stamps_[neighbour] != stamp_ + side) {
+                    stamps_[neighbour] = stamp_ + side;
+                    half.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    //! Replacement edge
+    /** Every non-tree edge leaving the smaller half ends in the other one. */
+    for (vertex current : sides_[smaller]) {
+        for (vertex neighbour : non_tree_[current]) {
+            if (stamps_[neighbour] == stamp_ + smaller) {
+                continue;
+            }
+
+            erase(non_tree_[current], neighbour);
+            erase(non_tree_[neighbour], current);
+            --non_tree_edges_;
+
+            forest_.link(current, neighbour);
+            tree_[current].push_back(neighbour);
+            tree_[neighbour].push_back(current);
+            return true;
+        }
+    }
+
+    return false;
+}
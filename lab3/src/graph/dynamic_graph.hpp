@@ -0,0 +1,59 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <vector>
+
+#include "graph/csr.hpp"
+#include "graph/link_cut_tree.hpp"
+
+namespace graph {
+    //! Graph under edge insertions and deletions with cycle queries
+    /** Keeps a spanning forest of the graph in a link-cut tree; every other edge, self-loops
+        included, is a non-tree edge. The graph has a cycle if and only if some non-tree edge
+        exists, so the query is O(1).
+
+        Insertion takes amortized O(log V). Deletion of a non-tree edge is O(degree). Deletion
+        of a tree edge splits a tree in two; both halves are walked in turn until the smaller one
+        is complete, then its non-tree edges are scanned for a replacement. This is
+        O(smaller half + its non-tree edges), far below a new search of the whole graph.
+        Edges are a set, like in `csr`: inserting an existing edge changes nothing. */
+    class dynamic_graph {
+        link_cut_tree                    forest_;
+        std::vector<std::vector<vertex>> tree_;
+        std::vector<std::vector<vertex>> non_tree_;
+        size_t                           non_tree_edges_ = 0;
+
+        //! Scratch of tree edge deletion
+        /** Half of the split a vertex was reached from is stamp of the deletion plus 0 or 1. */
+        std::vector<size_t>              stamps_;
+        size_t                           stamp_ = 0;
+        std::vector<vertex>              sides_[2];
+
+    public:
+        explicit dynamic_graph(csr const& graph);
+
+        size_t vertices_count() const noexcept {
+            return tree_.size();
+        }
+
+        //! has cycle
+        bool has_cycle() const noexcept {
+            return non_tree_edges_ != 0;
+        }
+
+        //! add
+        /** Inserts edge (u, v). Returns false if it is already present.
+            Throws `std::runtime_error` if some end is out of range. */
+        bool add(vertex u, vertex v);
+
+        //! remove
+        /** Deletes edge (u, v). Returns false if it is absent.
+            Throws `std::runtime_error` if some end is out of range. */
+        bool remove(vertex u, vertex v);
+
+    private:
+        void check(vertex u, vertex v) const;
+        bool reconnect(vertex u, vertex v);
+    };
+}
@@ -0,0 +1,122 @@
+#include "graph/link_cut_tree.hpp"
+
+/* stdlib: */
+#include <utility>
+
+bool graph::link_cut_tree::connected(vertex u, vertex v) {
+    return u == v || find_root(u) == find_root(v);
+}
+
+void graph::link_cut_tree::link(vertex u, vertex v) {
+    make_root(u);
+    nodes_[u].parent = v;
+}
+
+void graph::link_cut_tree::cut(vertex u, vertex v) {
+    // After rerooting at `u` the path to `v` is just the edge, `u` is the left child of `v`
+    make_root(u);
+    access(v);
+
+    nodes_[u].parent   = no_vertex;
+    nodes_[v].child[0] = no_vertex;
+}
+
+//! is root
+/** Returns true if `v` is the root of its splay tree. Parent of such a vertex, if any,
+    is the path-parent pointer to the next preferred path. */
+bool graph::link_cut_tree::is_root(vertex v) const noexcept {
+    vertex const parent = nodes_[v].parent;
+    return parent == no_vertex || (nodes_[parent].child[0] != v && nodes_[parent].child[1] != v);
+}
+
+//! push
+/** Applies pending reversal of the subtree of `v` to its children. */
+void graph::link_cut_tree::push(vertex v) noexcept {
+    node& current = nodes_[v];
+    if (!current.flip) {
+        return;
+    }
+
+    std::swap(current.child[0], current.child[1]);
+    for (vertex child : current.child) {
+        if (child != no_vertex) {
+            nodes_[child].flip = !nodes_[child].flip;
+        }
+    }
+    current.flip = false;
+}
+
+void graph::link_cut_tree::rotate(vertex v) noexcept {
+    vertex const parent      = nodes_[v].parent;
+    vertex const grandparent = nodes_[parent].parent;
+    int const    side        = nodes_[parent].child[1] == v;
+
+    if (!is_root(parent)) {
+        nodes_[grandparent].child[nodes_[grandparent].child[1] == parent] = v;
+    }
+    nodes_[v].parent = grandparent;
+
+    vertex const moved = nodes_[v].child[side ^ 1];
+    nodes_[parent].child[side] = moved;
+    if (moved != no_vertex) {
+        nodes_[moved].parent = parent;
+    }
+
+    nodes_[v].child[side ^ 1] = parent;
+    nodes_[parent].parent     = v;
+}
+
+void graph::link_cut_tree::splay(vertex v) {
+    // Pending reversals are pushed from the top of the splay tree down to `v`
+    path_.clear();
+    for (vertex current = v;; current = nodes_[current].parent) {
+        path_.push_back(current);
+        if (is_root(current)) {
+            break;
+        }
+    }
+    for (auto it = path_.rbegin(); it != path_.rend(); ++it) {
+        push(*it);
+    }
+
+    while (!is_root(v)) {
+        vertex const parent = nodes_[v].parent;
+        if (!is_root(parent)) {
+            vertex const grandparent = nodes_[parent].parent;
+            bool const   zig_zig     = (nodes_[grandparent].child[0] == parent) == (nodes_[parent].child[0] == v);
+            rotate(zig_zig ? parent : v);
+        }
+        rotate(v);
+    }
+}
+
+//! access
+/** Makes path from the root of the tree to `v` preferred, `v` becomes root of its splay tree
+    with no right child. */
+void graph::link_cut_tree::access(vertex v) {
+    vertex last = no_vertex;
+    for (vertex current = v; current != no_vertex; current = nodes_[current].parent) {
+        splay(current);
+        nodes_[current].child[1] = last;
+        last = current;
+    }
+    splay(v);
+}
+
+void graph::link_cut_tree::make_root(vertex v) {
+    access(v);
+    nodes_[v].flip = !nodes_[v].flip;
+    push(v);
+}
+
+graph::vertex graph::link_cut_tree::find_root(vertex v) {
+    access(v);
+
+    vertex root = v;
+    for (push(root); nodes_[root].child[0] != no_vertex; push(root)) {
+        root = nodes_[root].child[0];
+    }
+    splay(root);
+
+    return root;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <vector>
+
+#include "graph/csr.hpp"
+
+namespace graph {
+    //! Link-cut tree
+    /** Dynamic forest of unrooted trees over a fixed set of vertices. Every tree is split into
+        preferred paths kept in splay trees; `link`, `cut` and `connected` take amortized
+        O(log V). Trees are rerooted on demand, so edges may be cut in either direction. */
+    class link_cut_tree {
+        struct node {
+            vertex child[2] = { no_vertex, no_vertex };
+            vertex parent   = no_vertex;
+            bool   flip     = false;
+        };
+
+        std::vector<node>   nodes_;
+        std::vector<vertex> path_;
+
+    public:
+        explicit link_cut_tree(size_t vertices_count)
+            : nodes_(vertices_count) {}
+
+        //! connected
+        /** Returns true if `u` and `v` are in the same tree. */
+        bool connected(vertex u, vertex v);
+
+        //! link
+        /** Adds edge between `u` and `v`, which must be in different trees. */
+        void link(vertex u, vertex v);
+
+        //! cut
+        /** Removes edge between `u` and `v`, which must be in the forest. */
+        void cut(vertex u, vertex v);
+
+    private:
+        bool is_root(vertex v) const noexcept;
+        void push(vertex v) noexcept;
+        void rotate(vertex v) noexcept;
+        void splay(vertex v);
+        void access(vertex v);
+        void make_root(vertex v);
+        vertex find_root(vertex v);
+    };
+}
@@ -0,0 +1,499 @@
+#include "graph/loader.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+#include "runtime/bits.hpp"
+#include "runtime/mapped_file.hpp"
+#include "runtime/workers.hpp"
+
+namespace {
+    using word = std::uint64_t;
+
+    auto constexpr ones = word(0x0101010101010101);
+    auto constexpr high = word(0x8080808080808080);
+
+    //! Parse errors found by workers
+    enum class parse_error {
+        NONE,
+        MALFORMED,
+        OUT_OF_RANGE,
+    };
+
+    //! load word
+    /** Reads 8 bytes, first character goes to the lowest byte (little-endian targets only). */
+    inline word load_word(char const* p) noexcept {
+        word w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+    }
+
+    inline bool is_digit(char c) noexcept {
+        return unsigned(c - '0') < 10;
+    }
+
+    inline bool is_space(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    //! digits mask
+    /** Sets high bit of every byte of `w` that is an ASCII digit.
+        After xor digits become 0..9; adding 0x76 to the low 7 bits carries into the high bit
+        exactly for values >= 10 and never crosses byte boundary. */
+    inline word digits_mask(word w) noexcept {
+        word const x = w ^ (ones * '0');
+        return ~((x & ~high) + ones * (0x80 - 10)) & ~x & high;
+    }
+
+    //! parse eight digits
+    /** Converts 8 ASCII digits, first one in the lowest byte, with three multiplications. */
+    inline word parse_eight_digits(word w) noexcept {
+        w -= ones * '0';
+        w = (w * 10) + (w >> 8);
+        w = (((w & 0x000000FF000000FF) * 0x000F424000000064) +
+             (((w >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+        return w;
+    }
+
+    //! count tokens
+    /** Counts digit runs in [first, last). Runs start where a digit follows a non-digit. */
+    size_t count_tokens(char const* first, char const* last) noexcept {
+        size_t tokens = 0;
+        word   carry  = 0;
+
+        char const* p = first;
+        for (; last - p >= 8; p += 8) {
+            word const digits = digits_mask(load_word(p));
+            tokens += runtime::popcount(digits & ~((digits << 8) | carry));
+            carry = (digits >> 56) & 0x80;
+        }
+
+        bool previous_digit = carry != 0;
+        for (; p < last; ++p) {
+            bool const digit = is_digit(*p);
+            tokens += digit && !previous_digit;
+            previous_digit = digit;
+        }
+
+        return tokens;
+    }
+
+    //! parse number
+    /** Parses digit run starting at `p` and moves `p` behind it.
+        Returns false if the number is too long to fit into 64 bits. */
+    bool parse_number(char const*& p, char const* last, word* value) noexcept {
+        auto constexpr maximum_digits = unsigned(19);
+
+        word     result = 0;
+        unsigned digits = 0;
+
+        if (last - p >= 8) {
+            word const w      = load_word(p);
+            word const others = ~digits_mask(w) & high;
+            unsigned   length = others != 0 ? runtime::count_trailing_zeros(others) / 8 : 8;
+
+            // Vacated low bytes are filled by '0' which become leading zeros
+            unsigned const shift = 8 * (8 - length);
+            word const     fill  = shift != 0 ? (ones * '0') >> (64 - shift) : 0;
+
+            result = parse_eight_digits(shift != 0 ? (w << shift) | fill : w);
+            digits = length;
+            p += length;
+            if (length < 8) {
+                *value = result;
+                return true;
+            }
+        }
+
+        // Tail of the buffer or more than 8 digits
+        for (; p < last && is_digit(*p); ++p, ++digits) {
+            result = result * 10 + word(*p - '0');
+        }
+        *value = result;
+
+        return digits <= maximum_digits;
+    }
+
+    //! parse chunk
+    /** Parses numbers from [first, last). `token` is the global index of the first number,
+        number `t` is written to the first or the second end of edge `t / 2`,
+        so pairs may span chunk boundaries. */
+    parse_error parse_chunk(char const* first, char const* last, size_t token, size_t vertices_count,
+                            graph::edge* edges) noexcept {
+        for (char const* p = first; p < last;) {
+            if (is_space(*p)) {
+                ++p;
+                continue;
+            }
+            if (!is_digit(*p)) {
+                return parse_error::MALFORMED;
+            }
+
+            word value;
+            if (!parse_number(p, last, &value) || (p < last && !is_space(*p))) {
+                return parse_error::MALFORMED;
+            }
+            if (value >= vertices_count) {
+                return parse_error::OUT_OF_RANGE;
+            }
+
+            auto& e = edges[token / 2];
+            (token % 2 == 0 ? e.u : e.v) = graph::vertex(value);
+            ++token;
+        }
+
+        return parse_error::NONE;
+    }
+
+    //! read stdin
+    /** Reads the whole stdin in large blocks. */
+    std::vector<char> read_stdin() {
+        auto constexpr block_size = size_t(16) << 20;
+
+        std::vector<char> buffer;
+        size_t            size = 0;
+        for (;;) {
+            buffer.resize(size + block_size);
+            size_t const read = std::fread(buffer.data() + size, 1, block_size, stdin);
+            size += read;
+            if (read < block_size) {
+                break;
+            }
+        }
+        buffer.resize(size);
+
+        return buffer;
+    }
+}
+
+namespace {
+    //! parse header
+    /** Parses number of vertices at `p` and moves `p` behind it.
+        Throws `std::runtime_error` if it is missing or out of the supported range. */
+    size_t parse_header(char const*& p, char const* last) {
+        using std::runtime_error;
+        using std::numeric_limits;
+
+        auto constexpr minimum_number_of_vertices = size_t(2);
+        auto constexpr maximum_number_of_vertices = size_t(numeric_limits<graph::vertex>::max());
+
+        while (p < last && is_space(*p)) {
+            ++p;
+        }
+        word number_of_vertices;
+        if (p == last || !is_digit(*p) || !parse_number(p, last, &number_of_vertices)
+            || (p < last && !is_space(*p))) {
+            throw runtime_error("incorrect input");
+        }
+        if (number_of_vertices < minimum_number_of_vertices) {
+            throw runtime_error("number of vertices is too low");
+        }
+        if (number_of_vertices > maximum_number_of_vertices) {
+            throw runtime_error("number of vertices is too high");
+        }
+
+        return size_t(number_of_vertices);
+    }
+
+    //! parse edges
+    /** Parses numbers of [first, last) as ends of edges; number `t` goes to edge `(first_token + t) / 2`,
+        so with odd `first_token` the first number completes the already started last edge of `edges`.
+        The text is split into chunks at line ends, chunks are parsed by `threads_count` workers
+        straight into `edges`, which is resized to hold every started edge.
+        Returns number of parsed numbers. Throws `std::runtime_error` on malformed input
+        or vertex out of range. */
+    size_t parse_edges(char const* first, char const* last, size_t first_token, size_t vertices_count,
+                       size_t threads_count, std::vector<graph::edge>& edges) {
+        using std::vector;
+        using std::atomic;
+        using std::runtime_error;
+
+        threads_count = std::max<size_t>(threads_count, 1);
+
+        //! Split text into chunks
+        /** Boundaries are moved to the next line end, so no number is cut in two. */
+        size_t const        chunks_count = threads_count * 4;
+        vector<char const*> bounds(chunks_count + 1, last);
+        bounds[0] = first;
+        for (size_t i = 1; i < chunks_count; ++i) {
+            char const* bound = std::max(bounds[i - 1], first + runtime::split(size_t(last - first), chunks_count, i).first);
+            bound = std::find(bound, last, '\n');
+            bounds[i] = bound == last ? last : bound + 1;
+        }
+
+        //! Count numbers
+        /** Exact number of tokens gives position of each chunk in the single edge array. */
+        vector<size_t> tokens(chunks_count + 1, 0);
+        atomic<size_t> next_chunk = 0;
+        auto for_each_chunk = [&](auto&& callback) {
+            next_chunk = 0;
+            runtime::run_workers(threads_count, [&](size_t) {
+                for (size_t i = next_chunk++; i < chunks_count; i = next_chunk++) {
+                    callback(i);
+                }
+            });
+        };
+
+        tokens[0] = first_token;
+        for_each_chunk([&](size_t i) {
+            tokens[i + 1] = count_tokens(bounds[i], bounds[i + 1]);
+        });
+        for (size_t i = 0; i < chunks_count; ++i) {
+            tokens[i + 1] += tokens[i];
+        }
+
+        //! Parse chunks
+        /** Edge array starts at the edge of `first_token`. */
+        size_t const first_edge = first_token / 2;
+        edges.resize((tokens[chunks_count] + 1) / 2 - first_edge);
+
+        vector<parse_error> errors(chunks_count, parse_error::NONE);
+        for_each_chunk([&](size_t i) {
+            errors[i] = parse_chunk(bounds[i], bounds[i + 1], tokens[i] - 2 * first_edge, vertices_count, edges.data());
+        });
+        for (auto error : errors) {
+            if (error == parse_error::MALFORMED) {
+                throw runtime_error("incorrect input");
+            }
+            if (error == parse_error::OUT_OF_RANGE) {
+                throw runtime_error("vertex index is out of range");
+            }
+        }
+
+        return tokens[chunks_count] - first_token;
+    }
+}
+
+graph::edge_list graph::parse_edge_list(char const* data, size_t size, size_t threads_count) {
+    using std::runtime_error;
+
+    char const* p    = data;
+    char const* last = data + size;
+
+    //! Header
+    /** Number of vertices is parsed sequentially, everything behind it is the edge list. */
+    edge_list result;
+    result.vertices_count = parse_header(p, last);
+
+    size_t const tokens = parse_edges(p, last, 0, result.vertices_count, threads_count, result.edges);
+    if (tokens % 2 != 0) {
+        throw runtime_error("incorrect input");
+    }
+
+    return result;
+}
+
+std::vector<graph::edge_list> graph::parse_batch(char const* data, size_t size) {
+    using std::runtime_error;
+    using std::numeric_limits;
+
+    char const* p    = data;
+    char const* last = data + size;
+
+    //! next number
+    /** Skips spaces and parses the next number, throws if there is none. */
+    auto next_number = [&]() -> word {
+        while (p < last && is_space(*p)) {
+            ++p;
+        }
+        word value;
+        if (p == last || !is_digit(*p) || !parse_number(p, last, &value) || (p < last && !is_space(*p))) {
+            throw runtime_error("incorrect input");
+        }
+        return value;
+    };
+
+    word const graphs_count = next_number();
+
+    std::vector<edge_list> graphs;
+    graphs.reserve(size_t(std::min<word>(graphs_count, size / 4)));
+    for (word g = 0; g < graphs_count; ++g) {
+        word const vertices_count = next_number();
+        word const edges_count    = next_number();
+        if (vertices_count > numeric_limits<vertex>::max() || edges_count > size / 4) {
+            throw runtime_error("incorrect input");
+        }
+
+        edge_list graph;
+        graph.vertices_count = size_t(vertices_count);
+        graph.edges.resize(size_t(edges_count));
+        for (auto& e : graph.edges) {
+            word const u = next_number();
+            word const v = next_number();
+            if (u >= vertices_count || v >= vertices_count) {
+                throw runtime_error("vertex index is out of range");
+            }
+            e = { vertex(u), vertex(v) };
+        }
+        graphs.push_back(std::move(graph));
+    }
+
+    // Nothing but spaces may follow the last graph
+    while (p < last && is_space(*p)) {
+        ++p;
+    }
+    if (p != last) {
+        throw runtime_error("incorrect input");
+    }
+
+    return graphs;
+}
+
+std::vector<graph::edge_list> graph::load_batch(std::string const& path, load_report* report) {
+    using clock = std::chrono::steady_clock;
+
+    auto const begin = clock::now();
+
+    std::vector<edge_list> result;
+    size_t                 bytes;
+    if (path.empty()) {
+        auto const buffer = read_stdin();
+        bytes  = buffer.size();
+        result = parse_batch(buffer.data(), buffer.size());
+    } else {
+        runtime::mapped_file const file(path);
+        bytes  = file.size();
+        result = parse_batch(file.data(), file.size());
+    }
+
+    if (report != nullptr) {
+        report->bytes   = bytes;
+        report->seconds = std::chrono::duration<double>(clock::now() - begin).count();
+    }
+
+    return result;
+}
+
+graph::edge_list graph::load_edge_list(std::string const& path, size_t threads_count, load_report* report) {
+    using clock = std::chrono::steady_clock;
+
+    auto const begin = clock::now();
+
+    edge_list result;
+    size_t    bytes;
+    if (path.empty()) {
+        auto const buffer = read_stdin();
+        bytes  = buffer.size();
+        result = parse_edge_list(buffer.data(), buffer.size(), threads_count);
+    } else {
+        runtime::mapped_file const file(path);
+        bytes  = file.size();
+        result = parse_edge_list(file.data(), file.size(), threads_count);
+    }
+
+    if (report != nullptr) {
+        report->bytes   = bytes;
+        report->seconds = std::chrono::duration<double>(clock::now() - begin).count();
+    }
+
+    return result;
+}
+
+graph::edge_stream::edge_stream(std::string const& path, size_t block_size, size_t threads_count)
+    : block_(std::max<size_t>(block_size, 4096))
+    , threads_count_(threads_count) {
+    using std::runtime_error;
+
+    if (path.empty()) {
+        file_ = stdin;
+    } else {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            throw runtime_error("can not open '" + path + "'");
+        }
+        std::error_code error;
+        total_bytes_ = size_t(std::filesystem::file_size(path, error));
+    }
+
+    try {
+        // Header is short, the first block holds it unless the input is empty
+        fill();
+        char const* p    = block_.data();
+        char const* last = block_.data() + kept_;
+        vertices_count_ = parse_header(p, last);
+
+        kept_ = size_t(last - p);
+        std::memmove(block_.data(), p, kept_);
+    }
+    catch (...) {
+        if (file_ != stdin) {
+            std::fclose(file_);
+        }
+        throw;
+    }
+}
+
+graph::edge_stream::~edge_stream() {
+    if (file_ != stdin) {
+        std::fclose(file_);
+    }
+}
+
+void graph::edge_stream::fill() {
+    size_t const read = std::fread(block_.data() + kept_, 1, block_.size() - kept_, file_);
+    if (read < block_.size() - kept_) {
+        if (std::ferror(file_)) {
+            throw std::runtime_error("can not read input");
+        }
+        end_ = true;
+    }
+    kept_       += read;
+    bytes_read_ += read;
+}
+
+bool graph::edge_stream::next(std::vector<edge>& edges) {
+    using std::runtime_error;
+
+    edges.clear();
+    if (kept_ == 0 && end_) {
+        if (has_carry_) {
+            throw runtime_error("incorrect input");
+        }
+        return false;
+    }
+    if (!end_) {
+        fill();
+    }
+
+    //! Cut the block after the last space
+    /** Bytes behind it may be a part of a number continued in the next block. */
+    char const* first = block_.data();
+    char const* last  = block_.data() + kept_;
+    if (!end_) {
+        while (last > first && !is_space(last[-1])) {
+            --last;
+        }
+        if (last == first) {
+            throw runtime_error("incorrect input");
+        }
+    }
+
+    if (has_carry_) {
+        edges.push_back({ carry_, 0 });
+    }
+    size_t const tokens = parse_edges(first, last, has_carry_ ? 1 : 0, vertices_count_, threads_count_, edges);
+
+    // Edge started by an odd number is completed by the next block
+    has_carry_ = (tokens + (has_carry_ ? 1 : 0)) % 2 != 0;
+    if (has_carry_) {
+        carry_ = edges.back().u;
+        edges.pop_back();
+    }
+
+    kept_ = size_t(block_.data() + kept_ - last);
+    std::memmove(block_.data(), last, kept_);
+
+    return true;
+}
+
+void graph::edge_stream::resize_block(size_t block_size) {
+    block_.resize(std::max({ block_size, kept_, size_t(4096) }));
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "graph/csr.hpp"
+
+namespace graph {
+    //! Parsed input graph
+    struct edge_list {
+        size_t            vertices_count = 0;
+        std::vector<edge> edges;
+    };
+
+    //! Statistics of the last load
+    struct load_report {
+        size_t bytes   = 0;
+        double seconds = 0;
+
+        double megabytes_per_second() const noexcept {
+            return seconds > 0 ? double(bytes) / (1024 * 1024) / seconds : 0;
+        }
+    };
+
+    //! parse edge list
+    /** Parses text "vertices_count u v u v ..." separated by whitespace.
+        The text is split into chunks at line ends, chunks are parsed by `threads_count` workers
+        with a word-at-a-time digit parser straight into one preallocated edge array.
+        Throws `std::runtime_error` on malformed input or vertex out of range. */
+    edge_list parse_edge_list(char const* data, size_t size, size_t threads_count);
+
+    //! load edge list
+    /** Memory-maps file at `path`, or reads the whole stdin in large blocks if `path` is empty,
+        and parses it with `parse_edge_list`. */
+    edge_list load_edge_list(std::string const& path, size_t threads_count, load_report* report = nullptr);
+
+    //! Edge list read block by block
+    /** Text of `parse_edge_list` is read from a file, or from stdin if `path` is empty, in blocks
+        of `block_size` bytes and parsed by `threads_count` workers, so input of any size takes
+        the block and edges parsed from it. Number cut by the block end waits for the next block.
+        Throws `std::runtime_error` like `parse_edge_list` does. */
+    class edge_stream {
+        std::FILE*        file_           = nullptr;
+        std::vector<char> block_;
+        size_t            kept_           = 0;
+        size_t            threads_count_  = 1;
+        size_t            vertices_count_ = 0;
+        size_t            bytes_read_     = 0;
+        size_t            total_bytes_    = 0;
+        bool              has_carry_      = false;
+        vertex            carry_          = 0;
+        bool              end_            = false;
+
+    public:
+        edge_stream(std::string const& path, size_t block_size, size_t threads_count);
+        ~edge_stream();
+
+        edge_stream(edge_stream const&) = delete;
+        edge_stream& operator=(edge_stream const&) = delete;
+
+        size_t vertices_count() const noexcept {
+            return vertices_count_;
+        }
+
+        //! Bytes read so far
+        size_t bytes_read() const noexcept {
+            return bytes_read_;
+        }
+
+        //! Size of the input file, 0 for stdin
+        size_t total_bytes() const noexcept {
+            return total_bytes_;
+        }
+
+        //! resize block
+        /** Sets size of the following blocks, bytes read but not parsed yet are kept. */
+        void resize_block(size_t block_size);
+
+        //! next
+        /** Replaces `edges` by edges of the next block. Returns false at the end of input. */
+        bool next(std::vector<edge>& edges);
+
+    private:
+        //! fill
+        /** Appends next bytes of input to the kept ones. */
+        void fill();
+    };
+
+    //! parse batch
+    /** Parses many graphs from text "graphs_count" followed by "vertices_count edges_count u v u v ..."
+        of every graph, separated by whitespace. Graphs of a batch are expected to be small,
+        so the text is parsed sequentially. Throws `std::runtime_error` on malformed input
+        or vertex out of range. */
+    std::vector<edge_list> parse_batch(char const* data, size_t size);
+
+    //! load batch
+    /** Reads batch like `load_edge_list` does and parses it with `parse_batch`. */
+    std::vector<edge_list> load_batch(std::string const& path, load_report* report = nullptr);
+}
@@ -0,0 +1,166 @@
+#include "graph/reorder.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "runtime/workers.hpp"
+
+namespace {
+    using graph::vertex;
+    using graph::csr;
+
+    //! Vertices by descending degree, ties keep input order
+    std::vector<vertex> degree_order(csr const& graph) {
+        using std::vector;
+
+        size_t const vertices_count = graph.vertices_count();
+
+        size_t max_degree = 0;
+        for (size_t v = 0; v < vertices_count; ++v) {
+            max_degree = std::max(max_degree, graph.degree(vertex(v)));
+        }
+
+        // Start of every degree bucket, largest degree first
+        vector<size_t> starts(max_degree + 2, 0);
+        for (size_t v = 0; v < vertices_count; ++v) {
+            ++starts[max_degree - graph.degree(vertex(v)) + 1];
+        }
+        std::partial_sum(starts.begin(), starts.end(), starts.begin());
+
+        vector<vertex> order(vertices_count);
+        for (size_t v = 0; v < vertices_count; ++v) {
+            order[starts[max_degree - graph.degree(vertex(v))]++] = vertex(v);
+        }
+        return order;
+    }
+
+    //! Reverse Cuthill-McKee order
+    /** Breadth-first from a vertex of minimal degree, neighbours taken by ascending degree. */
+    std::vector<vertex> rcm_order(csr const& graph) {
+        using std::vector;
+
+        size_t const vertices_count = graph.vertices_count();
+
+        vector<vertex> by_degree = degree_order(graph);
+        std::reverse(by_degree.begin(), by_degree.end());
+
+        vector<bool>   placed(vertices_count, false);
+        vector<vertex> order;
+        vector<vertex> row;
+        order.reserve(vertices_count);
+        for (vertex root : by_degree) {
+            if (placed[root]) {
+                continue;
+            }
+            placed[root] = true;
+            order.push_back(root);
+
+            for (size_t i = order.size() - 1; i < order.size(); ++i) {
+                vertex const current = order[i];
+
+                row.clear();
+                for (auto it = graph.begin(current); it != graph.end(current); ++it) {
+                    if (!placed[*it]) {
+                        placed[*it] = true;
+                        row.push_back(*it);
+                    }
+                }
+                std::sort(row.begin(), row.end(), [&](vertex a, vertex b) {
+                    return graph.degree(a) < graph.degree(b);
+                });
+                order.insert(order.end(), row.begin(), row.end());
+            }
+        }
+
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+}
+
+graph::ordering graph::parse_ordering(std::string const& name) {
+    if (name == "none") {
+        return ordering::NONE;
+    }
+    if (name == "degree") {
+        return ordering::DEGREE;
+    }
+    if (name == "rcm") {
+        return ordering::RCM;
+    }
+
+    throw std::runtime_error("unknown ordering '" + name + "'");
+}
+
+char const* graph::ordering_name(ordering order) noexcept {
+    switch (order) {
+    case ordering::NONE:
+        return "none";
+    case ordering::DEGREE:
+        return "degree";
+    case ordering::RCM:
+        return "rcm";
+    }
+
+    return "unknown";
+}
+
+graph::relabeled_csr graph::reorder(csr const& graph, ordering order, size_t threads_count) {
+    using std::vector;
+
+    threads_count = std::max<size_t>(threads_count, 1);
+
+    size_t const vertices_count = graph.vertices_count();
+
+    relabeled_csr result;
+    switch (order) {
+    case ordering::NONE:
+        result.original.resize(vertices_count);
+        std::iota(result.original.begin(), result.original.end(), vertex(0));
+        result.graph = graph;
+        return result;
+    case ordering::DEGREE:
+        result.original = degree_order(graph);
+        break;
+    case ordering::RCM:
+        result.original = rcm_order(graph);
+        break;
+    }
+
+    // Searches of one component start from vertex 0, so it keeps its label
+    if (vertices_count != 0) {
+        std::iter_swap(result.original.begin(), std::find(result.original.begin(), result.original.end(), vertex(0)));
+    }
+
+    //! New labels
+    vector<vertex> labels(vertices_count);
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t v = first; v < last; ++v) {
+            labels[result.original[v]] = vertex(v);
+        }
+    });
+
+    vector<edge_index> offsets(vertices_count + 1, 0);
+    for (size_t v = 0; v < vertices_count; ++v) {
+        offsets[v + 1] = offsets[v] + graph.degree(result.original[v]);
+    }
+
+    //! Relabel rows
+    /** Rows keep their sizes, so every worker fills its own rows in place and sorts them. */
+    vector<vertex> neighbours(offsets[vertices_count]);
+    runtime::run_workers(threads_count, [&](size_t worker) {
+        auto [first, last] = runtime::split(vertices_count, threads_count, worker);
+        for (size_t v = first; v < last; ++v) {
+            vertex const source = result.original[v];
+            auto const   row    = neighbours.begin() + offsets[v];
+
+            std::transform(graph.begin(source), graph.end(source), row, [&](vertex w) { return labels[w]; });
+            std::sort(row, row + graph.degree(source));
+        }
+    });
+
+    result.graph = csr(std::move(offsets), std::move(neighbours));
+    return result;
+}
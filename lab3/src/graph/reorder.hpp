@@ -0,0 +1,39 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "graph/csr.hpp"
+
+namespace graph {
+    //! Vertex orders for better cache locality
+    enum class ordering {
+        NONE,    ///< keep input labels
+        DEGREE,  ///< vertices by descending degree, hubs share cache lines
+        RCM,     ///< reverse Cuthill-McKee, neighbours get close labels
+    };
+
+    //! parse ordering
+    /** Returns ordering by its command line name, throws `std::runtime_error` for unknown one. */
+    ordering parse_ordering(std::string const& name);
+
+    //! ordering name
+    char const* ordering_name(ordering order) noexcept;
+
+    //! Graph with relabeled vertices
+    /** `original[v]` is the input label of vertex `v` of `graph`. */
+    struct relabeled_csr {
+        csr                 graph;
+        std::vector<vertex> original;
+    };
+
+    //! reorder
+    /** Computes the order and returns graph with vertex `original[i]` relabeled to `i`.
+        Degree order is a counting sort, RCM runs sequentially from a vertex of minimal degree
+        in every component. Rows of the new graph are filled by `threads_count` workers.
+        Vertex 0 keeps its label, so searches from vertex 0 see the same component.
+        Works for directed graphs too, only rows are relabeled. */
+    relabeled_csr reorder(csr const& graph, ordering order, size_t threads_count);
+}
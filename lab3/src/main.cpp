@@ -1,283 +1,455 @@
 /* stdlib: */
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <fstream>
 #include <vector>
+#include <string>
 #include <sstream>
 #include <iostream>
-#include <type_traits>
-#include <utility>
-#include <tuple>
-#include <mutex>
+#include <stdexcept>
 #include <thread>
 
-/* WINAPI: */
-#include <Windows.h>
-#include <processthreadsapi.h>
-
-/* Threading building blocks: */
-#include <tbb/concurrent_queue.h>
-#include <tbb/mutex.h>
-#include <tbb/atomic.h>
-
-template<typename callable>
-static DWORD thread_launcher(LPVOID data) {
-    static_assert(std::is_invocable_v<callable>, "can not start from not callable");
-
-    callable* callback = static_cast<callable*>(data);
-    std::invoke(*callback);
-
-    return EXIT_SUCCESS;
-}
+#include "graph/binary.hpp"
+#include "graph/csr.hpp"
+#include "graph/dynamic_graph.hpp"
+#include "graph/reorder.hpp"
+#include "graph/loader.hpp"
+#include "engines/batch.hpp"
+#include "engines/directed.hpp"
+#include "engines/engines.hpp"
+#include "engines/external.hpp"
+#include "runtime/instrumentation.hpp"
+#include "runtime/thread_pool.hpp"
 
 //! cpus count
 /** Returns cpus count. If `required` is 0 function returns number of available cpus.
     If `required` is greater than available cpus the maximum will be returned. */
 static size_t cpus_count(size_t required = 0) noexcept {
-    size_t possible;
-    SYSTEM_INFO sysinfo;
+    size_t const available = std::max(1u, std::thread::hardware_concurrency());
 
-    ::GetSystemInfo(&sysinfo);
     if (required == 0) {
-        possible = size_t(sysinfo.dwNumberOfProcessors);
-    }
-    else {
-        possible = min(required, size_t(sysinfo.dwNumberOfProcessors));
+        return available;
     }
-
-    return possible;
+    return std::min(required, available);
 }
 
-static void parse(int argc, char* argv[], size_t* cpus_count) {
+//! Command line options
+struct options {
+    size_t               cpus           = 0;
+    engines::engine_type engine         = engines::engine_type::AUTO;
+    std::string          input;
+    bool                 verbose        = false;
+    bool                 all_components = false;
+    bool                 witness        = false;
+    bool                 daemon         = false;
+    bool                 verify         = false;
+    bool                 directed       = false;
+    std::string          convert;
+    std::string          profile;
+    graph::ordering      order          = graph::ordering::NONE;
+    bool                 batch          = false;
+    bool                 stream         = false;
+    size_t               memory         = 1024;
+    std::string          spill;
+    runtime::placement   affinity       = runtime::placement::NONE;
+};
+
+//! parse
+/** Usage: App [cpus] [--engine auto|dfs|bfs|union-find|frontier|dense|hybrid] [--all-components] [--input path]
+               [--affinity none|compact|spread] [--witness] [--daemon] [--convert path] [--verify]
+               [--directed] [--profile path] [--reorder none|degree|rcm] [--batch]
+               [--stream] [--memory MB] [--spill directory] [--verbose]
+    Graph is read from stdin if no input file is given. Union-find engine always checks
+    all components, bfs engine checks only the component of vertex 0. Auto engine, the default,
+    treats cpus as an upper bound and picks the sequential dfs or the frontier engine with as many
+    workers as the size of the graph pays for, see `engines::choose_plan`. Dense engine searches
+    the adjacency matrix and takes graphs of up to 65536 vertices. Affinity pins workers
+    to processors filling NUMA nodes one by one (compact) or in turn (spread). Witness prints
+    vertices of the found cycle in order. Daemon loads the graph from the input file and then
+    serves commands from stdin, see `serve`. Convert writes the input graph to a binary file and
+    exits; binary input files are recognized and mapped without parsing, verify checks their
+    checksum first. Directed treats edge (u, v) as going from u to v and searches for a directed
+    cycle with the trimming engine instead of the selected one. Profile writes counters and
+    phase timeline as JSON at exit, it needs a build with LAB3_INSTRUMENTATION. Reorder relabels
+    vertices for cache locality before the search, witness is printed with input labels.
+    Batch reads many graphs, see `graph::parse_batch`, and prints one answer per graph.
+    Stream searches an edge list larger than memory within the memory budget (1024 MB by default),
+    spilling to the given or the temporary directory, see `engines::run_external`. */
+static void parse(int argc, char* argv[], options* opts) {
+    using std::string;
     using std::stringstream;
     using std::runtime_error;
 
-    if (argc > 2) {
-        throw runtime_error("too many arguments");
-    }
-    if (argc == 1) {
-        return;
-    }
-
-    size_t cpus;
-    auto cpus_count_str = argv[1];
-    stringstream stream(cpus_count_str);
-    stream >> cpus;
-    if (stream.fail()) {
-        throw runtime_error("incorrect arguments");
-    }
-
-    *cpus_count = cpus;
-}
-
-static void read_input(std::istream& in, std::vector<std::vector<bool>>& links) {
-    using std::vector;
-    using std::runtime_error;
+    bool cpus_parsed = false;
+    for (int i = 1; i < argc; ++i) {
+        string const argument = argv[i];
 
-    auto constexpr minimum_number_of_vertices = 2;
-    auto constexpr maximum_number_of_vertices = 1000;
-
-    size_t number_of_vertices;
-    in >> number_of_vertices;
-    if (in.fail()) {
-        throw runtime_error("incorrect input");
-    }
-    if (number_of_vertices < minimum_number_of_vertices) {
-        throw runtime_error("number of vertices is too low");
-    }
-    if (number_of_vertices > maximum_number_of_vertices) {
-        throw runtime_error("number of vertices is too high");
-    }
-
-    links = vector(number_of_vertices, vector(number_of_vertices, false));
-    while (in) {
-        size_t u, v;
-        in >> u >> v;
-        if (in.fail()) {
-            if (!in.eof()) {
-                throw runtime_error("incorrect input");
+        if (argument == "--engine") {
+            if (++i == argc) {
+                throw runtime_error("engine name expected");
+            }
+            opts->engine = engines::parse_engine(argv[i]);
+            continue;
+        }
+        if (argument == "--input") {
+            if (++i == argc) {
+                throw runtime_error("input path expected");
+            }
+            opts->input = argv[i];
+            continue;
+        }
+        if (argument == "--affinity") {
+            if (++i == argc) {
+                throw runtime_error("affinity expected");
+            }
+            opts->affinity = runtime::parse_placement(argv[i]);
+            continue;
+        }
+        if (argument == "--all-components") {
+            opts->all_components = true;
+            continue;
+        }
+        if (argument == "--witness") {
+            opts->witness = true;
+            continue;
+        }
+        if (argument == "--convert") {
+            if (++i == argc) {
+                throw runtime_error("output path expected");
+            }
+            opts->convert = argv[i];
+            continue;
+        }
+        if (argument == "--profile") {
+            if (++i == argc) {
+                throw runtime_error("profile path expected");
+            }
+            if (!runtime::instrumentation::enabled) {
+                throw runtime_error("profile needs a build with LAB3_INSTRUMENTATION");
+            }
+            opts->profile = argv[i];
+            continue;
+        }
+        if (argument == "--reorder") {
+            if (++i == argc) {
+                throw runtime_error("ordering expected");
+            }
+            opts->order = graph::parse_ordering(argv[i]);
+            continue;
+        }
+        if (argument == "--verify") {
+            opts->verify = true;
+            continue;
+        }
+        if (argument == "--stream") {
+            opts->stream = true;
+            continue;
+        }
+        if (argument == "--memory") {
+            if (++i == argc) {
+                throw runtime_error("memory budget expected");
+            }
+            stringstream stream(argv[i]);
+            if (!(stream >> opts->memory) || opts->memory == 0) {
+                throw runtime_error("incorrect memory budget");
             }
             continue;
         }
+        if (argument == "--spill") {
+            if (++i == argc) {
+                throw runtime_error("spill directory expected");
+            }
+            opts->spill = argv[i];
+            continue;
+        }
+        if (argument == "--batch") {
+            opts->batch = true;
+            continue;
+        }
+        if (argument == "--directed") {
+            opts->directed = true;
+            continue;
+        }
+        if (argument == "--daemon") {
+            opts->daemon = true;
+            continue;
+        }
+        if (argument == "--verbose") {
+            opts->verbose = true;
+            continue;
+        }
+
+        if (cpus_parsed) {
+            throw runtime_error("too many arguments");
+        }
+
+        size_t cpus;
+        stringstream stream(argument);
+        stream >> cpus;
+        if (stream.fail()) {
+            throw runtime_error("incorrect arguments");
+        }
 
-        links[u][v] = true;
-        links[v][u] = true;
+        opts->cpus  = cpus;
+        cpus_parsed = true;
     }
 }
 
-static int run_parallel_bfs(std::vector<std::vector<bool>>& links, size_t threads_count) {
-    using std::pair;
-    using std::tuple;
-    using std::vector;
-    using tbb::concurrent_bounded_queue;
-    using tbb::mutex;
-    using tbb::atomic;
+//! serve
+/** Answers commands, one per line, until the end of input:
+        add u v     insert edge
+        del u v     delete edge
+        has-cycle   print "cycle exists: true|false"
+    Answers are kept up to date on every change, so a query does not search the graph.
+    Malformed command, including one with extra words or a vertex out of range,
+    is reported to stderr and skipped. */
+static void serve(graph::dynamic_graph& graph, std::istream& in, std::ostream& out) {
+    using std::string;
+    using std::stringstream;
     using std::cerr;
     using std::endl;
-    using std::terminate;
-
-    typedef size_t index;
-    typedef size_t from_index;
 
-    enum class task_type {
-        STOP,
-        CONTINUE,
-    };
-
-    enum class report_type {
-        REPORT,
-        SEARCH_COMPLETED
-    };
+    string line;
+    while (std::getline(in, line)) {
+        stringstream stream(line);
+        string       command;
+        if (!(stream >> command)) {
+            continue;
+        }
 
-    using task   = tuple<task_type, index, from_index>;
-    using report = pair<report_type, bool>;
-
-    auto constexpr start           = 0;
-    auto constexpr cycle_found     = true;
-    auto constexpr cycle_not_found = false;
-
-    //! Synchronization resources
-    concurrent_bounded_queue<task>   tasks;
-    concurrent_bounded_queue<report> reports;
-    vector<bool>                     map(links.size(), false);
-    mutex                            map_lock;
-    atomic<size_t>                   threads_blocked = 0;
-
-    //! Thread routine.
-    /** Main procedure that is running in each search thread. */
-    auto routine = [&]() -> void {
-        task t;
-        bool search_completed = false;
-        while (!search_completed) {
-            //! blocked is used to check how many threads now are blocked
-            /** If count of blocked threads is `threads_count - 1` then we are nearly
-                to complete workers block. To avoid it we send report that all threads are done
-                and waiting for a STOP task. */
-            size_t blocked = threads_blocked.fetch_and_increment();
-            if (blocked + 1 == threads_count) {
-                reports.emplace(report_type::SEARCH_COMPLETED, false);
+        try {
+            // Ids are read signed, so a negative one is not wrapped into range
+            long long u = 0, v = 0;
+            bool const edge = command == "add" || command == "del";
+            if ((edge && !(stream >> u >> v)) || (!edge && command != "has-cycle") || !(stream >> std::ws).eof()) {
+                throw std::runtime_error("unknown command '" + line + "'");
             }
-            tasks.pop(t);
-            threads_blocked.fetch_and_decrement();
-
-            // Unpack next task
-            auto [type, current, from] = t;
-
-            // Check task because that may be STOP message
-            if (type == task_type::STOP) {
-                search_completed = true;
+            if (command == "has-cycle") {
+                out << "cycle exists: " << (graph.has_cycle() ? "true" : "false") << endl;
                 continue;
             }
 
-            // Update map
-            // Scope created for RAII
-            {
-                std::lock_guard<decltype(map_lock)> lock(map_lock);
-
-                //! been_here is a reference
-                /** The type of been_here is a special wrapper because we used std::vector<bool>
-                    that has well memory optimization.
-                    But in context of algorithm this variable is a boolean that we use to check
-                    where we have been before. */
-                auto been_before = map[current];
-                if (been_before == false) {
-                    been_before = true;
-                } else {
-                    reports.emplace(report_type::REPORT, cycle_found);
-                    continue;
+            for (long long id : { u, v }) {
+                if (id < 0 || static_cast<unsigned long long>(id) >= graph.vertices_count()) {
+                    throw std::runtime_error("vertex " + std::to_string(id) + " is out of range");
                 }
             }
-
-            // Remove path we came from
-            links[current][from] = false;
-
-            // Push new tasks
-            for (index i = 0; i < links.size(); ++i) {
-                if (links[current][i]) {
-                    tasks.emplace(task_type::CONTINUE, i, current);
-                }
+            if (command == "add") {
+                graph.add(graph::vertex(u), graph::vertex(v));
+            } else {
+                graph.remove(graph::vertex(u), graph::vertex(v));
             }
-
-            // Push information about current vertex
-            reports.emplace(report_type::REPORT, cycle_not_found);
         }
-    };
-
-    //! Initial state
-    /** Tell first thread to start from vertex with index that equals start. */
-    tasks.emplace(task_type::CONTINUE, start, start);
-
-    // Initialize threads
-    vector<HANDLE> threads(threads_count, HANDLE{ NULL });
-    for (auto& thread : threads) {
-        thread = ::CreateThread(
-            NULL,
-            0,
-            thread_launcher<decltype(routine)>,
-            static_cast<LPVOID>(&routine),
-            NULL,
-            NULL
-        );
-        if (thread == NULL) {
-            // Fatal error, abort
-            cerr << "thread initialization failed, aborting..." << endl;
-            terminate();
+        catch (std::runtime_error& e) {
+            cerr << "error: " << e.what() << endl;
         }
     }
+}
 
-    //! Gathering reports
-    bool answer = false;
-    bool reports_done = false;
-    while (!reports_done) {
-        report result;
-        reports.pop(result);
-
-        switch (result.first) {
-        case report_type::REPORT:
-            // Update information about cycles in the graph
-            answer |= result.second;
-            if (!answer) {
-                // Cycle is still not found, continue operations
-                continue;
+//! solve batch
+/** Answers every graph of the batch in input order and reports the throughput. */
+static void solve_batch(options const& opts, size_t cpus) {
+    using std::cout;
+    using std::endl;
+    using clock = std::chrono::steady_clock;
+
+    // Graphs smaller than this are cheaper to solve on one thread than to split
+    auto constexpr inline_limit = size_t(1) << 16;
+
+    auto const begin = clock::now();
+
+    std::vector<graph::edge_list> const graphs = graph::load_batch(opts.input);
+    std::vector<bool> const answers = engines::run_batch(graphs, cpus, inline_limit,
+        [&](graph::edge_list const& input, size_t threads_count) {
+            if (input.vertices_count == 0) {
+                return false;
             }
-            [[ fallthrough ]];
-        case report_type::SEARCH_COMPLETED:
-            // Search completed, break loop
-            break;
-        }
+            if (opts.directed) {
+                graph::csr const graph = graph::build_directed_csr(input.vertices_count, input.edges, threads_count);
+                return engines::run_directed_trim(graph, threads_count);
+            }
+            graph::csr const graph = graph::build_csr(input.vertices_count, input.edges, threads_count);
+            return engines::run(opts.engine, graph, threads_count, opts.all_components);
+        });
 
-        reports_done = true;
-    }
+    double const seconds = std::chrono::duration<double>(clock::now() - begin).count();
 
-    // Abort all threads
-    for (size_t i = 0; i < threads_count; i++) {
-        tasks.emplace(task_type::STOP, 0, 0);
+    for (bool answer : answers) {
+        cout << "cycle exists: " << (answer ? "true" : "false") << '\n';
     }
+    cout << "graphs: " << graphs.size() << " in " << seconds << " s ("
+         << (seconds > 0 ? double(graphs.size()) / seconds : 0) << " graphs/s)" << endl;
+}
+
+//! solve stream
+/** Searches the input out of core, reporting progress to stderr at most once a second. */
+static void solve_stream(options const& opts, size_t cpus) {
+    using std::cout;
+    using std::cerr;
+    using std::endl;
+    using clock = std::chrono::steady_clock;
+
+    auto constexpr megabyte = double(1 << 20);
+
+    auto last_report = clock::now();
+
+    engines::external_settings settings;
+    settings.memory_budget   = opts.memory << 20;
+    settings.spill_directory = opts.spill;
+    settings.threads_count   = cpus;
+    settings.all_components  = opts.all_components;
+    settings.progress        = [&](engines::external_progress const& progress) {
+        auto const now = clock::now();
+        if (now - last_report < std::chrono::seconds(1) && progress.bytes_done != progress.bytes_total) {
+            return;
+        }
+        last_report = now;
 
-    // Wait for threads
-    ::WaitForMultipleObjects(DWORD(threads.size()), threads.data(), TRUE, INFINITE);
+        cerr << progress.stage << ": " << double(progress.bytes_done) / megabyte;
+        if (progress.bytes_total != 0) {
+            cerr << " / " << double(progress.bytes_total) / megabyte;
+        }
+        cerr << " MB (" << progress.megabytes_per_second() << " MB/s), spilled "
+             << double(progress.bytes_spilled) / megabyte << " MB" << endl;
+    };
 
-    return answer;
+    bool const result = engines::run_external(opts.input, settings);
+    cout << "cycle exists: " << (result ? "true" : "false") << endl;
 }
 
+//! Writes instrumentation dump when leaving main
+struct profile_dump {
+    std::string path;
+
+    ~profile_dump() {
+        if (path.empty()) {
+            return;
+        }
+        std::ofstream file(path);
+        runtime::instrumentation::dump_json(file);
+    }
+};
+
 int main(int argc, char* argv[]) try {
     using std::vector;
-    using std::cin;
     using std::cout;
     using std::cerr;
     using std::endl;
 
-    // Get cpus count
-    size_t cpus = 0;
-    parse(argc, argv, &cpus);
-    cpus = cpus_count(cpus);
+    // Get cpus count and engine
+    options opts;
+    parse(argc, argv, &opts);
+    size_t const cpus = cpus_count(opts.cpus);
+    runtime::configure_default_pool(cpus, opts.affinity);
+    profile_dump const dump{ opts.profile };
+    if (opts.daemon && opts.input.empty()) {
+        throw std::runtime_error("daemon reads commands from stdin, graph must be given with --input");
+    }
+    if (opts.daemon && opts.directed) {
+        throw std::runtime_error("daemon supports only undirected graphs");
+    }
+    if (opts.batch && (opts.daemon || opts.witness || !opts.convert.empty() || opts.order != graph::ordering::NONE)) {
+        throw std::runtime_error("batch can not be combined with daemon, witness, convert or reorder");
+    }
+
+    if (opts.stream && (opts.batch || opts.daemon || opts.witness || opts.directed || !opts.convert.empty()
+                        || opts.order != graph::ordering::NONE)) {
+        throw std::runtime_error("stream can not be combined with batch, daemon, witness, directed, convert or reorder");
+    }
 
-    // Get input data
-    vector<vector<bool>> links;
-    read_input(cin, links);
+    if (opts.batch) {
+        solve_batch(opts, cpus);
+        return EXIT_SUCCESS;
+    }
+    if (opts.stream) {
+        solve_stream(opts, cpus);
+        return EXIT_SUCCESS;
+    }
+
+    graph::csr            graph;
+    vector<graph::vertex> original;
+    if (!opts.input.empty() && graph::is_binary_csr(opts.input)) {
+        // Binary graph is used right from the mapping
+        runtime::instrumentation::phase const loading("load");
+        auto const begin = std::chrono::steady_clock::now();
+        graph = graph::map_binary_csr(opts.input, opts.verify, cpus, opts.directed);
+        if (opts.verbose) {
+            cerr << "mapped " << graph.vertices_count() << " vertices in "
+                 << std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() << " s" << endl;
+        }
+    } else {
+        // Get input data
+        graph::load_report report;
+        graph::edge_list   input;
+        {
+            runtime::instrumentation::phase const loading("load");
+            input = graph::load_edge_list(opts.input, cpus, &report);
+        }
+        if (opts.verbose) {
+            cerr << "parsed " << report.bytes << " bytes in " << report.seconds << " s ("
+                 << report.megabytes_per_second() << " MB/s)" << endl;
+        }
+
+        // Build adjacency
+        runtime::instrumentation::phase const building("build");
+        graph = opts.directed ? graph::build_directed_csr(input.vertices_count, input.edges, cpus)
+                              : graph::build_csr(input.vertices_count, input.edges, cpus);
+    }
+
+    // Save graph in binary format instead of searching
+    if (!opts.convert.empty()) {
+        graph::save_binary_csr(graph, opts.convert, cpus, opts.directed);
+        cout << "saved " << graph.vertices_count() << " vertices and " << graph.neighbours_count()
+             << " neighbours to " << opts.convert << endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Keep answering changes of the graph
+    if (opts.daemon) {
+        graph::dynamic_graph dynamic(graph);
+        serve(dynamic, std::cin, cout);
+        return EXIT_SUCCESS;
+    }
+
+    // Relabel vertices for locality
+    if (opts.order != graph::ordering::NONE) {
+        runtime::instrumentation::phase const reordering("reorder");
+        auto const begin = std::chrono::steady_clock::now();
+
+        graph::relabeled_csr relabeled = graph::reorder(graph, opts.order, cpus);
+        graph    = std::move(relabeled.graph);
+        original = std::move(relabeled.original);
+        if (opts.verbose) {
+            cerr << "reordered by " << graph::ordering_name(opts.order) << " in "
+                 << std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() << " s" << endl;
+        }
+    }
 
     // Run parallel search of cycles in graph
-    bool result = run_parallel_bfs(links, cpus);
+    engines::cycle witness;
+    engines::cycle* const witness_output = opts.witness ? &witness : nullptr;
+    bool result;
+    {
+        runtime::instrumentation::phase const searching("search");
+        if (opts.verbose && !opts.directed && opts.engine == engines::engine_type::AUTO) {
+            engines::plan const chosen = engines::choose_plan(graph, cpus);
+            cerr << "engine " << engines::engine_name(chosen.engine) << " on " << chosen.threads_count
+                 << " threads" << endl;
+        }
+        result = opts.directed ? engines::run_directed_trim(graph, cpus, witness_output)
+                               : engines::run(opts.engine, graph, cpus, opts.all_components, witness_output);
+    }
     cout << "cycle exists: " << (result ? "true" : "false") << endl;
 
+    if (result && opts.witness) {
+        cout << "cycle:";
+        for (graph::vertex v : witness) {
+            cout << ' ' << (original.empty() ? v : original[v]);
+        }
+        cout << endl;
+    }
+
     return EXIT_SUCCESS;
 }
 catch (std::exception& e) {
@@ -0,0 +1,32 @@
+#pragma once
+
+/* stdlib: */
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace runtime {
+    //! popcount
+    /** Returns number of set bits in `value`. */
+    inline unsigned popcount(std::uint64_t value) noexcept {
+#if defined(_MSC_VER)
+        return unsigned(__popcnt64(value));
+#else
+        return unsigned(__builtin_popcountll(value));
+#endif
+    }
+
+    //! count trailing zeros
+    /** Returns index of the lowest set bit, `value` must not be zero. */
+    inline unsigned count_trailing_zeros(std::uint64_t value) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return unsigned(index);
+#else
+        return unsigned(__builtin_ctzll(value));
+#endif
+    }
+}
@@ -0,0 +1,91 @@
+#include "runtime/instrumentation.hpp"
+
+/* stdlib: */
+#include <stdexcept>
+
+#ifdef LAB3_INSTRUMENTATION
+/* stdlib: */
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+    using runtime::instrumentation::counter;
+    using runtime::instrumentation::clock;
+
+    auto constexpr max_workers    = size_t(256);
+    auto constexpr counters_count = size_t(counter::COUNT);
+
+    char const* const counter_names[counters_count] = {
+        "vertices_expanded",
+        "edges_scanned",
+        "queue_wait_ns",
+        "sync_wait_ns",
+        "join_wait_ns",
+    };
+
+    //! Counters of one worker
+    struct alignas(64) worker_slot {
+        std::atomic<std::uint64_t> values[counters_count] = {};
+    };
+
+    struct phase_record {
+        char const* name;
+        double      start;
+        double      seconds;
+    };
+
+    worker_slot               slots[max_workers];
+    clock::time_point const   started = clock::now();
+    std::mutex                phases_lock;
+    std::vector<phase_record> phases;
+}
+
+void runtime::instrumentation::add(size_t worker, counter which, std::uint64_t value) noexcept {
+    slots[worker % max_workers].values[size_t(which)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void runtime::instrumentation::record_phase(char const* name, clock::time_point begin, clock::time_point end) {
+    using std::chrono::duration;
+
+    std::lock_guard<std::mutex> guard(phases_lock);
+    phases.push_back({ name, duration<double>(begin - started).count(), duration<double>(end - begin).count() });
+}
+
+void runtime::instrumentation::dump_json(std::ostream& out) {
+    out << "{\n  \"threads\": [";
+
+    bool first = true;
+    for (size_t worker = 0; worker < max_workers; ++worker) {
+        auto const& values = slots[worker].values;
+
+        bool used = false;
+        for (auto const& value : values) {
+            used |= value.load(std::memory_order_relaxed) != 0;
+        }
+        if (!used) {
+            continue;
+        }
+
+        out << (first ? "\n" : ",\n") << "    { \"worker\": " << worker;
+        for (size_t i = 0; i < counters_count; ++i) {
+            out << ", \"" << counter_names[i] << "\": " << values[i].load(std::memory_order_relaxed);
+        }
+        out << " }";
+        first = false;
+    }
+
+    out << "\n  ],\n  \"phases\": [";
+
+    std::lock_guard<std::mutex> guard(phases_lock);
+    for (size_t i = 0; i < phases.size(); ++i) {
+        out << (i == 0 ? "\n" : ",\n") << "    { \"name\": \"" << phases[i].name << "\", \"start\": "
+            << phases[i].start << ", \"seconds\": " << phases[i].seconds << " }";
+    }
+    out << "\n  ]\n}\n";
+}
+#else
+void runtime::instrumentation::dump_json(std::ostream&) {
+    throw std::runtime_error("instrumentation is not built in, configure with LAB3_INSTRUMENTATION=ON");
+}
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+/* stdlib: */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace runtime {
+    namespace instrumentation {
+        //! Instrumentation switch
+        /** Set by the LAB3_INSTRUMENTATION build option. When it is off every probe below is
+            an empty inline function, so instrumented code compiles to the same instructions. */
+#ifdef LAB3_INSTRUMENTATION
+        bool constexpr enabled = true;
+#else
+        bool constexpr enabled = false;
+#endif
+
+        //! Per-thread counters
+        enum class counter {
+            VERTICES_EXPANDED,  ///< vertices taken out of a queue or frontier and expanded
+            EDGES_SCANNED,      ///< neighbours looked at
+            QUEUE_WAIT_NS,      ///< time blocked in task queue pops
+            SYNC_WAIT_NS,       ///< time waiting on barriers and locks
+            JOIN_WAIT_NS,       ///< time the caller waited for other workers to finish a job
+            COUNT,
+        };
+
+        using clock = std::chrono::steady_clock;
+
+#ifdef LAB3_INSTRUMENTATION
+        void add(size_t worker, counter which, std::uint64_t value) noexcept;
+        void record_phase(char const* name, clock::time_point begin, clock::time_point end);
+
+        //! Time spent in the scope added to a counter
+        class wait_timer {
+            size_t            worker_;
+            counter           which_;
+            clock::time_point begin_;
+
+        public:
+            wait_timer(size_t worker, counter which) noexcept
+                : worker_(worker)
+                , which_(which)
+                , begin_(clock::now()) {}
+
+            ~wait_timer() {
+                auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin_);
+                add(worker_, which_, std::uint64_t(elapsed.count()));
+            }
+
+            wait_timer(wait_timer const&) = delete;
+            wait_timer& operator=(wait_timer const&) = delete;
+        };
+
+        //! Scope recorded in the timeline of phases
+        class phase {
+            char const*       name_;
+            clock::time_point begin_;
+
+        public:
+            explicit phase(char const* name) noexcept
+                : name_(name)
+                , begin_(clock::now()) {}
+
+            ~phase() {
+                record_phase(name_, begin_, clock::now());
+            }
+
+            phase(phase const&) = delete;
+            phase& operator=(phase const&) = delete;
+        };
+#else
+        inline void add(size_t, counter, std::uint64_t) noexcept {}
+
+        class wait_timer {
+        public:
+            wait_timer(size_t, counter) noexcept {}
+        };
+
+        class phase {
+        public:
+            explicit phase(char const*) noexcept {}
+        };
+#endif
+
+        //! dump json
+        /** Writes counters of every worker that counted anything and the timeline of phases.
+            Throws `std::runtime_error` if instrumentation is not built in. */
+        void dump_json(std::ostream& out);
+    }
+}
@@ -0,0 +1,110 @@
+#include "runtime/mapped_file.hpp"
+
+/* stdlib: */
+#include <stdexcept>
+
+#ifdef _WIN32
+/*
+ * Windows implementation
+ */
+#include <Windows.h>
+
+runtime::mapped_file::mapped_file(std::string const& path, access_pattern pattern) {
+    using std::runtime_error;
+
+    HANDLE file = ::CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | (pattern == access_pattern::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : 0),
+        NULL
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw runtime_error("can not open '" + path + "'");
+    }
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        throw runtime_error("can not get size of '" + path + "'");
+    }
+    size_ = size_t(size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        ::CloseHandle(file);
+        throw runtime_error("can not map '" + path + "'");
+    }
+    handle_ = mapping;
+
+    data_ = static_cast<char const*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        throw runtime_error("can not map '" + path + "'");
+    }
+}
+
+runtime::mapped_file::~mapped_file() {
+    if (data_ != nullptr) {
+        ::UnmapViewOfFile(data_);
+    }
+    if (handle_ != nullptr) {
+        ::CloseHandle(handle_);
+    }
+    if (file_ != nullptr) {
+        ::CloseHandle(file_);
+    }
+}
+
+#else
+/*
+ * POSIX implementation
+ */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+runtime::mapped_file::mapped_file(std::string const& path, access_pattern pattern) {
+    using std::runtime_error;
+
+    int const descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw runtime_error("can not open '" + path + "'");
+    }
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw runtime_error("can not get size of '" + path + "'");
+    }
+    size_ = size_t(status.st_size);
+
+    if (size_ != 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (data == MAP_FAILED) {
+            ::close(descriptor);
+            throw runtime_error("can not map '" + path + "'");
+        }
+        ::madvise(data, size_, pattern == access_pattern::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_NORMAL);
+        data_ = static_cast<char const*>(data);
+    }
+
+    // Mapping keeps the file alive
+    ::close(descriptor);
+}
+
+runtime::mapped_file::~mapped_file() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+#endif
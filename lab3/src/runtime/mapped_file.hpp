@@ -0,0 +1,38 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <string>
+
+namespace runtime {
+    //! Expected order of reads from a mapping, a hint for the read-ahead of the system
+    enum class access_pattern {
+        SEQUENTIAL,  ///< read once from start to end, pages behind are dropped early
+        NORMAL,      ///< read in any order, as graph arrays by a search
+    };
+
+    //! Read-only memory mapping of the whole file
+    /** Pages are shared with the page cache, so nothing is copied until it is touched.
+        Throws `std::runtime_error` if the file can not be opened or mapped. */
+    class mapped_file {
+        char const* data_   = nullptr;
+        size_t      size_   = 0;
+        void*       file_   = nullptr;
+        void*       handle_ = nullptr;
+
+    public:
+        explicit mapped_file(std::string const& path, access_pattern pattern = access_pattern::SEQUENTIAL);
+        ~mapped_file();
+
+        mapped_file(mapped_file const&) = delete;
+        mapped_file& operator=(mapped_file const&) = delete;
+
+        char const* data() const noexcept {
+            return data_;
+        }
+
+        size_t size() const noexcept {
+            return size_;
+        }
+    };
+}
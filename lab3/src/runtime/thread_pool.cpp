@@ -0,0 +1,212 @@
+#include "runtime/thread_pool.hpp"
+
+/* stdlib: */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+#include "runtime/instrumentation.hpp"
+#include "runtime/topology.hpp"
+
+namespace {
+    //! Processor order for the placement
+    std::vector<size_t> processors(runtime::placement where) {
+        using std::vector;
+        using runtime::placement;
+
+        vector<size_t> order;
+        if (where == placement::NONE) {
+            return order;
+        }
+
+        auto const nodes = runtime::numa_nodes();
+        if (where == placement::COMPACT) {
+            for (auto const& node : nodes) {
+                order.insert(order.end(), node.begin(), node.end());
+            }
+            return order;
+        }
+
+        for (size_t i = 0;; ++i) {
+            bool taken = false;
+            for (auto const& node : nodes) {
+                if (i < node.size()) {
+                    order.push_back(node[i]);
+                    taken = true;
+                }
+            }
+            if (!taken) {
+                return order;
+            }
+        }
+    }
+
+    std::unique_ptr<runtime::thread_pool>& default_pool_storage() {
+        static std::unique_ptr<runtime::thread_pool> pool;
+        return pool;
+    }
+}
+
+runtime::placement runtime::parse_placement(std::string const& name) {
+    if (name == "none") {
+        return placement::NONE;
+    }
+    if (name == "compact") {
+        return placement::COMPACT;
+    }
+    if (name == "spread") {
+        return placement::SPREAD;
+    }
+
+    throw std::runtime_error("unknown affinity '" + name + "'");
+}
+
+runtime::thread_pool::thread_pool(size_t threads_count, placement where)
+    : cpus_(processors(where)) {
+    if (!cpus_.empty()) {
+        pin_current_thread(cpus_[0]);
+    }
+    grow(std::max<size_t>(threads_count, 1) - 1);
+}
+
+runtime::thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void runtime::thread_pool::grow(size_t threads_count) {
+    // Threads start from the generation before the next job, so a late start cannot miss it
+    size_t const seen = generation_.load(std::memory_order_relaxed);
+    while (threads_.size() < threads_count) {
+        size_t const index = threads_.size() + 1;
+        threads_.emplace_back([this, index, seen] { worker_loop(index, seen); });
+    }
+}
+
+void runtime::thread_pool::run(size_t workers_count, worker_routine const& routine) {
+    using std::lock_guard;
+    using std::unique_lock;
+    using std::mutex;
+
+    workers_count = std::max<size_t>(workers_count, 1);
+    if (workers_count == 1) {
+        // Nothing to share, skip wake-up entirely. This also lets a routine run
+        // single-worker jobs of its own
+        routine(0);
+        return;
+    }
+
+    lock_guard<mutex> serialize(run_lock_);
+    grow(workers_count - 1);
+
+    {
+        lock_guard<mutex> guard(lock_);
+        routine_ = &routine;
+        active_  = workers_count;
+        error_   = nullptr;
+        remaining_.store(workers_count - 1, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+    wake_.notify_all();
+
+    try {
+        routine(0);
+    } catch (...) {
+        lock_guard<mutex> guard(lock_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+
+    unique_lock<mutex> guard(lock_);
+    {
+        instrumentation::phase const joining("join");
+        instrumentation::wait_timer  timer(0, instrumentation::counter::JOIN_WAIT_NS);
+        done_.wait(guard, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+    }
+    routine_ = nullptr;
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+double runtime::thread_pool::job_overhead(size_t workers_count) {
+    using clock = std::chrono::steady_clock;
+
+    auto constexpr attempts = 5;
+
+    double best = 0;
+    for (int i = 0; i < attempts; ++i) {
+        auto const begin = clock::now();
+        run(workers_count, [](size_t) {});
+        double const seconds = std::chrono::duration<double>(clock::now() - begin).count();
+
+        best = i == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+void runtime::thread_pool::worker_loop(size_t index, size_t seen) {
+    using std::unique_lock;
+    using std::lock_guard;
+    using std::mutex;
+
+    if (!cpus_.empty()) {
+        pin_current_thread(cpus_[index % cpus_.size()]);
+    }
+
+    for (;;) {
+        worker_routine const* routine;
+        {
+            unique_lock<mutex> guard(lock_);
+            wake_.wait(guard, [&] {
+                return stopping_ || generation_.load(std::memory_order_relaxed) != seen;
+            });
+            if (stopping_) {
+                return;
+            }
+
+            seen = generation_.load(std::memory_order_relaxed);
+            if (index >= active_) {
+                // Job is smaller than the pool
+                continue;
+            }
+            routine = routine_;
+        }
+
+        try {
+            (*routine)(index);
+        } catch (...) {
+            lock_guard<mutex> guard(lock_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            lock_guard<mutex> guard(lock_);
+            done_.notify_one();
+        }
+    }
+}
+
+void runtime::configure_default_pool(size_t threads_count, placement where) {
+    default_pool_storage() = std::make_unique<thread_pool>(threads_count, where);
+}
+
+runtime::thread_pool& runtime::default_pool() {
+    auto& pool = default_pool_storage();
+    if (!pool) {
+        pool = std::make_unique<thread_pool>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    return *pool;
+}
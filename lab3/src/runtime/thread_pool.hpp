@@ -0,0 +1,79 @@
+#pragma once
+
+/* stdlib: */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "runtime/workers.hpp"
+
+namespace runtime {
+    //! Placement of pool threads on processors
+    enum class placement {
+        NONE,     ///< leave scheduling to the system
+        COMPACT,  ///< pin to processors filling one NUMA node before the next
+        SPREAD,   ///< pin to processors taking NUMA nodes in turn
+    };
+
+    placement parse_placement(std::string const& name);
+
+    //! Persistent worker pool
+    /** Threads are started once and sleep between jobs, so a query pays only for a wake-up.
+        The calling thread takes part in every job as worker 0. Jobs are not reentrant:
+        a routine may only start single-worker jobs, which run inline. */
+    class thread_pool {
+        std::vector<std::thread>   threads_;
+        std::vector<size_t>        cpus_;
+
+        std::mutex                 run_lock_;
+        std::mutex                 lock_;
+        std::condition_variable    wake_;
+        std::condition_variable    done_;
+        std::atomic<size_t>        generation_ = 0;
+        std::atomic<size_t>        remaining_  = 0;
+        worker_routine const*      routine_    = nullptr;
+        size_t                     active_     = 0;
+        bool                       stopping_   = false;
+        std::exception_ptr         error_;
+
+    public:
+        explicit thread_pool(size_t threads_count, placement where = placement::NONE);
+        ~thread_pool();
+
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        //! size
+        /** Returns number of workers including the calling thread. */
+        size_t size() const noexcept {
+            return threads_.size() + 1;
+        }
+
+        //! run
+        /** Runs `routine` on `workers_count` workers at once and waits for all of them.
+            Pool grows if it is too small. First exception thrown by a worker is rethrown. */
+        void run(size_t workers_count, worker_routine const& routine);
+
+        //! job overhead
+        /** Returns the shortest of a few measured runs of an empty job on `workers_count`
+            workers in seconds: the cost of waking the workers and waiting for all of them. */
+        double job_overhead(size_t workers_count);
+
+    private:
+        void grow(size_t threads_count);
+        void worker_loop(size_t index, size_t seen);
+    };
+
+    //! configure default pool
+    /** Creates pool used by `run_workers`; the calling thread becomes its worker 0. */
+    void configure_default_pool(size_t threads_count, placement where);
+
+    //! default pool
+    /** Returns pool used by `run_workers`, created with all processors on first use. */
+    thread_pool& default_pool();
+}
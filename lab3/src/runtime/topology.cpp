@@ -0,0 +1,146 @@
+#include "runtime/topology.hpp"
+
+/* stdlib: */
+#include <thread>
+
+#ifdef _WIN32
+/*
+ * Windows implementation
+ */
+#define NOMINMAX
+#include <Windows.h>
+
+std::vector<std::vector<size_t>> runtime::numa_nodes() {
+    using std::vector;
+
+    //! Only processor group 0 is used, that is up to 64 processors
+    vector<vector<size_t>> nodes;
+
+    ULONG highest = 0;
+    if (::GetNumaHighestNodeNumber(&highest)) {
+        for (USHORT node = 0; node <= highest; ++node) {
+            GROUP_AFFINITY affinity;
+            if (!::GetNumaNodeProcessorMaskEx(node, &affinity) || affinity.Group != 0) {
+                continue;
+            }
+
+            vector<size_t> cpus;
+            for (size_t cpu = 0; cpu < sizeof(KAFFINITY) * 8; ++cpu) {
+                if (affinity.Mask & (KAFFINITY(1) << cpu)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+    }
+
+    if (nodes.empty()) {
+        vector<size_t> cpus;
+        for (size_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+            cpus.push_back(cpu);
+        }
+        nodes.push_back(std::move(cpus));
+    }
+
+    return nodes;
+}
+
+bool runtime::pin_current_thread(size_t cpu) noexcept {
+    return ::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+}
+
+#else
+/*
+ * POSIX implementation
+ */
+#include <pthread.h>
+#include <sched.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+    //! parse cpu list
+    /** Parses kernel cpu list format, e.g. "0-3,8-11". */
+    std::vector<size_t> parse_cpu_list(std::string const& list) {
+        std::vector<size_t> cpus;
+        std::stringstream   stream(list);
+
+        for (std::string range; std::getline(stream, range, ',');) {
+            auto const dash = range.find('-');
+            try {
+                size_t const first = std::stoul(range.substr(0, dash));
+                size_t const last  = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+                for (size_t cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (std::exception const&) {
+                // Ignore empty or malformed entries
+            }
+        }
+
+        return cpus;
+    }
+}
+
+std::vector<std::vector<size_t>> runtime::numa_nodes() {
+    using std::vector;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool const restricted = ::sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    auto is_allowed = [&](size_t cpu) {
+        return !restricted || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+    };
+
+    vector<vector<size_t>> nodes;
+    for (size_t node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            break;
+        }
+
+        std::string list;
+        std::getline(file, list);
+
+        vector<size_t> cpus;
+        for (size_t cpu : parse_cpu_list(list)) {
+            if (is_allowed(cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+
+    if (nodes.empty()) {
+        vector<size_t> cpus;
+        for (size_t cpu = 0; cpu < CPU_SETSIZE && cpus.size() < std::thread::hardware_concurrency(); ++cpu) {
+            if (is_allowed(cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+        nodes.push_back(std::move(cpus));
+    }
+
+    return nodes;
+}
+
+bool runtime::pin_current_thread(size_t cpu) noexcept {
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+#endif
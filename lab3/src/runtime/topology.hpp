@@ -0,0 +1,16 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <vector>
+
+namespace runtime {
+    //! numa nodes
+    /** Returns processors available to the process grouped by NUMA node.
+        Systems without NUMA information are reported as one node. */
+    std::vector<std::vector<size_t>> numa_nodes();
+
+    //! pin current thread
+    /** Binds calling thread to the processor. Returns false if the system refused. */
+    bool pin_current_thread(size_t cpu) noexcept;
+}
@@ -0,0 +1,7 @@
+#include "runtime/workers.hpp"
+
+#include "runtime/thread_pool.hpp"
+
+void runtime::run_workers(size_t workers_count, worker_routine const& routine) {
+    default_pool().run(workers_count, routine);
+}
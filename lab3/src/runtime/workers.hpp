@@ -0,0 +1,29 @@
+#pragma once
+
+/* stdlib: */
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace runtime {
+    //! Worker routine
+    /** Receives index of the worker in range [0, workers count). */
+    using worker_routine = std::function<void(size_t)>;
+
+    //! run workers
+    /** Runs `routine` on `workers_count` threads of the default pool at once
+        and waits until all of them are done. */
+    void run_workers(size_t workers_count, worker_routine const& routine);
+
+    //! split
+    /** Returns bounds [first, last) of the `part`-th of `parts` almost equal pieces of [0, total). */
+    inline std::pair<size_t, size_t> split(size_t total, size_t parts, size_t part) noexcept {
+        size_t const base      = total / parts;
+        size_t const remainder = total % parts;
+
+        size_t const first = part * base + (part < remainder ? part : remainder);
+        size_t const last  = first + base + (part < remainder ? 1 : 0);
+
+        return { first, last };
+    }
+}
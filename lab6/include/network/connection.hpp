@@ -0,0 +1,156 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <zmq.hpp>
+
+#include <network/request.hpp>
+#include <network/response.hpp>
+
+namespace network
+{
+    /// Long-lived REQ connection to a single node
+    /**
+     * Socket is opened on the first request and kept open between requests, so each of them
+     * costs one round trip instead of a TCP connect and teardown. Request is posted and
+     * its reply is taken once the socket is readable, so many connections are waited at once.
+     *
+     * Request which reply is no longer waited for is abandoned, the socket is relaxed and
+     * correlated, so it sends the next request at once and drops the late reply to the old one.
+     * The node is busy until that late reply comes, see `idle`. Node which didn't reply in time
+     * is reset and the socket is reopened on the next request ("lazy pirate").
+    */
+    class connection
+    {
+        zmq::context_t*              context_;
+        std::string                  address_;
+        std::optional<zmq::socket_t> socket_;
+        bool                         waiting_ = false; ///< reply to the last request is not taken yet
+
+    public:
+        connection(zmq::context_t& context, std::string address)
+            : context_{&context}
+            , address_{std::move(address)}
+        {
+        }
+
+        /// Sends request, its reply is taken once the socket is readable
+        /**
+         * @param request: request that will be sent
+         * @return: false if the request wasn't sent
+        */
+        auto post(request const& request) -> bool
+        {
+            try
+            {
+                auto serialized_request = zmq::message_t{request.size()};
+                request.serialize_to(serialized_request);
+                if (not open().send(serialized_request, zmq::send_flags::none).has_value())
+                {
+                    return false;
+                }
+                waiting_ = true;
+                return true;
+            }
+            catch (zmq::error_t const&)
+            {
+                reset();
+                return false;
+            }
+        }
+
+        /// Takes reply to the posted request
+        /**
+         * Malformed reply, e.g. from a node of an older version, is taken for no reply
+         * and the connection is reset.
+         *
+         * @return: reply or nothing if there is no reply yet
+        */
+        auto take() -> std::optional<response>
+        {
+            auto serialized_response = zmq::message_t{};
+            if (not socket_.has_value() ||
+                not socket_->recv(serialized_response, zmq::recv_flags::dontwait).has_value())
+            {
+                return std::nullopt;
+            }
+
+            waiting_ = false;
+            try
+            {
+                auto response = network::response{};
+                response.deserialize_from(serialized_response);
+                return response;
+            }
+            catch (std::invalid_argument const&)
+            {
+                reset();
+                return std::nullopt;
+            }
+        }
+
+        /// Tells if the reply to the last request is still waited for
+        [[nodiscard]]
+        auto waiting() const noexcept -> bool
+        {
+            return waiting_;
+        }
+
+        /// Tells if the node is done with the requests sent to it
+        /**
+         * Late reply to the abandoned request is taken and dropped if it came.
+         *
+         * @return: false while the node is still busy with the abandoned request
+        */
+        auto idle() -> bool
+        {
+            if (waiting_)
+            {
+                std::ignore = take();
+            }
+            return not waiting_;
+        }
+
+        /// Item to poll the socket for the reply, valid until the socket is reset
+        [[nodiscard]]
+        auto poll_item() -> zmq::pollitem_t
+        {
+            return {static_cast<void*>(open()), 0, ZMQ_POLLIN, 0};
+        }
+
+        /// Drops the socket, next request opens a new one
+        auto reset() noexcept -> void
+        {
+            waiting_ = false;
+            socket_.reset();
+        }
+
+        [[nodiscard]]
+        auto address() const noexcept -> std::string const&
+        {
+            return address_;
+        }
+
+    private:
+        /// Returns the socket, connecting it first if there is none
+        auto open() -> zmq::socket_t&
+        {
+            if (not socket_.has_value())
+            {
+                //
+                // Pending messages are dropped on close instead of holding the context,
+                // next request may be sent before the reply and replies are matched to requests
+                //
+                socket_.emplace(*context_, ZMQ_REQ);
+                socket_->setsockopt(ZMQ_LINGER, 0);
+                socket_->setsockopt(ZMQ_REQ_RELAXED, 1);
+                socket_->setsockopt(ZMQ_REQ_CORRELATE, 1);
+                socket_->connect(address_);
+            }
+            return *socket_;
+        }
+    };
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace network
+{
+    /// Command of the framed request
+    enum class opcode : std::uint8_t
+    {
+        create,
+        remove,
+        exec,
+        ping,
+        pid,
+        kill,
+    };
+
+    [[nodiscard]]
+    auto inline to_string(opcode const code) noexcept -> std::string_view
+    {
+        switch (code)
+        {
+        case opcode::create:
+            return "create";
+        case opcode::remove:
+            return "remove";
+        case opcode::exec:
+            return "exec";
+        case opcode::ping:
+            return "ping";
+        case opcode::pid:
+            return "pid";
+        case opcode::kill:
+            return "kill";
+        }
+
+        return "INVALID_CODE";
+    }
+
+    [[nodiscard]]
+    auto inline parse_opcode(std::string_view const name) noexcept(false) -> opcode
+    {
+        for (auto code = std::uint8_t{0}; code <= static_cast<std::uint8_t>(opcode::kill); ++code)
+        {
+            if (to_string(static_cast<opcode>(code)) == name)
+            {
+                return static_cast<opcode>(code);
+            }
+        }
+
+        throw std::invalid_argument{"no such command '" + std::string{name} + "'"};
+    }
+
+    /// Binary request sent as the message
+    /**
+     * Little-endian layout:
+     *     version         : u8
+     *     request id      : u64, echoed in the response
+     *     target id       : i64
+     *     opcode          : u8
+     *     arguments count : u8
+     *     arguments       : u16 length followed by the bytes, for every argument
+     *
+     * Decoded frame refers to the bytes it was decoded from, so nodes read the target and
+     * forward the bytes as they are without any allocation.
+    */
+    struct frame
+    {
+        auto static constexpr version       = std::uint8_t{1};
+        auto static constexpr max_arguments = std::size_t{4};
+        auto static constexpr header_size   = std::size_t{1 + 8 + 8 + 1 + 1};
+
+        std::uint64_t                                request_id      = 0;
+        std::int64_t                                 target_id       = 0;
+        opcode                                       code            = opcode::ping;
+        std::array<std::string_view, max_arguments> arguments       = {};
+        std::size_t                                  arguments_count = 0;
+
+        /// Appends argument, bytes aren't copied
+        auto push(std::string_view const argument) noexcept(false) -> void
+        {
+            if (arguments_count == max_arguments)
+            {
+                throw std::invalid_argument{"too many arguments for '" + std::string{to_string(code)} + "'"};
+            }
+            if (argument.size() > UINT16_MAX)
+            {
+                throw std::invalid_argument{"argument is too long"};
+            }
+            arguments[arguments_count++] = argument;
+        }
+
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t
+        {
+            auto size = header_size;
+            for (auto i = std::size_t{0}; i < arguments_count; ++i)
+            {
+                size += 2 + arguments[i].size();
+            }
+            return size;
+        }
+
+        [[nodiscard]]
+        auto encode() const noexcept(false) -> std::string
+        {
+            auto bytes = std::string{};
+            bytes.reserve(size());
+
+            auto put = [&bytes](std::uint64_t const value, std::size_t const width) -> void
+            {
+                for (auto i = std::size_t{0}; i < width; ++i)
+                {
+                    bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+                }
+            };
+
+            put(version, 1);
+            put(request_id, 8);
+            put(static_cast<std::uint64_t>(target_id), 8);
+            put(static_cast<std::uint8_t>(code), 1);
+            put(arguments_count, 1);
+            for (auto i = std::size_t{0}; i < arguments_count; ++i)
+            {
+                put(arguments[i].size(), 2);
+                bytes.append(arguments[i]);
+            }
+
+            return bytes;
+        }
+
+        /// Reads request id of the frame without decoding the rest
+        /**
+         * Lets a node echo the id in the reply to a frame that fails to decode.
+         *
+         * @param bytes: encoded frame
+         * @return: request id or 0 if the frame is too short to have one
+        */
+        [[nodiscard]]
+        auto static request_id_of(std::string_view const bytes) noexcept -> std::uint64_t
+        {
+            return bytes.size() < 1 + 8 ? 0 : load(bytes, 1, 8);
+        }
+
+        /// Decodes frame, arguments refer to the given bytes
+        [[nodiscard]]
+        auto static decode(std::string_view const bytes) noexcept(false) -> frame
+        {
+            auto offset = std::size_t{0};
+            auto get    = [&](std::size_t const width) -> std::uint64_t
+            {
+                if (bytes.size() - offset < width)
+                {
+                    throw std::invalid_argument{"frame is truncated"};
+                }
+
+                auto const value = load(bytes, offset, width);
+                offset += width;
+                return value;
+            };
+
+            if (get(1) != version)
+            {
+                throw std::invalid_argument{"unsupported frame version"};
+            }
+
+            auto frame       = network::frame{};
+            frame.request_id = get(8);
+            frame.target_id  = static_cast<std::int64_t>(get(8));
+
+            auto const code = get(1);
+            if (code > static_cast<std::uint8_t>(opcode::kill))
+            {
+                throw std::invalid_argument{"invalid opcode"};
+            }
+            frame.code = static_cast<opcode>(code);
+
+            auto const count = get(1);
+            if (count > max_arguments)
+            {
+                throw std::invalid_argument{"too many arguments in frame"};
+            }
+            for (auto i = std::uint64_t{0}; i < count; ++i)
+            {
+                auto const length = get(2);
+                if (bytes.size() - offset < length)
+                {
+                    throw std::invalid_argument{"frame is truncated"};
+                }
+                frame.arguments[frame.arguments_count++] = bytes.substr(offset, length);
+                offset += length;
+            }
+
+            if (offset != bytes.size())
+            {
+                throw std::invalid_argument{"frame has trailing bytes"};
+            }
+
+            return frame;
+        }
+
+    private:
+        /// Reads little-endian value of the given width, bounds are checked by the caller
+        [[nodiscard]]
+        auto static load(std::string_view const bytes, std::size_t const offset, std::size_t const width) noexcept
+            -> std::uint64_t
+        {
+            auto value = std::uint64_t{0};
+            for (auto i = std::size_t{0}; i < width; ++i)
+            {
+                value |= std::uint64_t{static_cast<unsigned char>(bytes[offset + i])} << (8 * i);
+            }
+            return value;
+        }
+    };
+}
@@ -9,8 +9,8 @@ namespace network
     {
         enum class type : std::uint8_t
         {
-            envelope,
-            message
+            envelope, ///< liveness probe of the handshake protocol
+            message   ///< encoded network::frame
         };
 
         type        type;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -18,13 +19,14 @@ namespace network
 
     struct response
     {
-        error       error;
-        std::string message;
+        error         error;
+        std::string   message;
+        std::uint64_t request_id = 0; ///< id of the framed request this one replies to
 
         [[nodiscard]]
         auto size() const noexcept -> std::size_t
         {
-            return sizeof(error) + std::size(message);
+            return sizeof(error) + sizeof(request_id) + std::size(message);
         }
 
         template <typename Container>
@@ -43,11 +45,20 @@ namespace network
 
             auto* const data         = buffer.data();
             auto* const code_byte    = static_cast<network::error*>(data);
+            auto* const id_space     = static_cast<std::byte*>(data) + sizeof(network::error);
             auto* const string_space = reinterpret_cast<std::string::value_type*>(
-                static_cast<std::byte*>(data) +
-                sizeof(network::error));
+                id_space +
+                sizeof(request_id));
 
             *code_byte = error;
+
+            //
+            // Id is little-endian as in the frame, whatever the host order is
+            //
+            for (auto i = std::size_t{0}; i < sizeof(request_id); ++i)
+            {
+                id_space[i] = static_cast<std::byte>((request_id >> (8 * i)) & 0xFF);
+            }
             std::memcpy(string_space, message.data(), message.size());
         }
 
@@ -56,7 +67,7 @@ namespace network
         {
             auto const size = buffer.size();
 
-            if (size < sizeof(error))
+            if (size < sizeof(error) + sizeof(request_id))
             {
                 throw std::invalid_argument{"size of data in serialized buffer is too small"};
             }
@@ -67,12 +78,18 @@ namespace network
 
             auto const* const data         = buffer.data();
             auto const* const code_byte    = static_cast<const network::error*>(data);
+            auto const* const id_space     = static_cast<const std::byte*>(data) + sizeof(network::error);
             auto const* const string_space = reinterpret_cast<const std::string::value_type*>(
-                static_cast<const std::byte*>(data) +
-                sizeof(network::error));
+                id_space +
+                sizeof(request_id));
 
-            error    = *code_byte;
-            message = std::string{string_space, size - sizeof(error)};
+            error      = *code_byte;
+            request_id = 0;
+            for (auto i = std::size_t{0}; i < sizeof(request_id); ++i)
+            {
+                request_id |= std::uint64_t{std::to_integer<unsigned char>(id_space[i])} << (8 * i);
+            }
+            message = std::string{string_space, size - sizeof(error) - sizeof(request_id)};
         }
 
         [[nodiscard]]
@@ -1,11 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
 #include <set>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <zmq.hpp>
 
 #include <tasking/launcher.hpp>
+#include <utility/string.hpp>
+#include <network/connection.hpp>
+#include <network/frame.hpp>
 #include <network/request.hpp>
 #include <network/response.hpp>
 
@@ -13,21 +22,62 @@ namespace network::topology::tree
 {
     using namespace std::string_view_literals;
 
+    /// The way requests are forwarded to child nodes
+    enum class protocol : std::uint8_t
+    {
+        handshake, ///< 'envelope' probe first, then the message
+        direct,    ///< only the message, liveness comes from the child process state
+    };
+
+    [[nodiscard]]
+    auto inline to_string(protocol const protocol) noexcept -> std::string_view
+    {
+        switch (protocol)
+        {
+        case protocol::handshake:
+            return "handshake";
+        case protocol::direct:
+            return "direct";
+        }
+
+        return "INVALID_PROTOCOL";
+    }
+
+    [[nodiscard]]
+    auto inline parse_protocol(std::string_view const name) noexcept(false) -> protocol
+    {
+        if (name == to_string(protocol::handshake))
+        {
+            return protocol::handshake;
+        }
+        if (name == to_string(protocol::direct))
+        {
+            return protocol::direct;
+        }
+
+        throw std::invalid_argument{"no such protocol '" + std::string{name} + "'"};
+    }
+
     class engine
     {
         struct node
         {
-            tasking::task task;
-            std::string   address;
-            std::int64_t  id;
+            tasking::task       task;
+            network::connection connection;
+            std::int64_t        id;
         };
 
-        zmq::context_t& context_;
-        std::list<node> root_nodes_;
+        zmq::context_t&                                context_;
+        protocol                                       protocol_;
+        std::list<node>                                root_nodes_;
+        std::unordered_map<std::int64_t, std::int64_t> routes_; ///< node id to id of the child which subtree holds it
+        std::uint64_t                                  last_request_id_ = 0;
 
     public:
-        explicit engine(zmq::context_t& context)
+        /// Creates engine, its child nodes forward requests by the same protocol
+        explicit engine(zmq::context_t& context, protocol const protocol = protocol::direct)
             : context_{context}
+            , protocol_{protocol}
         {
         }
 
@@ -41,7 +91,7 @@ namespace network::topology::tree
             // Create new node parameters
             //
             auto const address = "tcp://*:" + std::to_string(port);
-            auto const args    = address + " " + std::to_string(id);
+            auto const args    = address + " " + std::to_string(id) + " " + std::string{to_string(protocol_)};
 
             //
             // Start new task
@@ -56,7 +106,7 @@ namespace network::topology::tree
             //
             root_nodes_.push_front({
                 .task = std::move(task),
-                .address = "tcp://localhost:" + std::to_string(port),
+                .connection = network::connection{context_, "tcp://localhost:" + std::to_string(port)},
                 .id = id,
             });
 
@@ -74,6 +124,8 @@ namespace network::topology::tree
                     }
                     throw std::runtime_error{response.message};
                 }
+
+                routes_.insert_or_assign(id, id);
                 return response;
             }
             catch (...)
@@ -104,16 +156,32 @@ namespace network::topology::tree
             return ask_every_until_response(target_id, request);
         }
 
-        /// Builds request string for the node with given id
-        auto static build_request(std::int64_t const id, std::string_view const message) -> std::string
+        /// Builds framed request for the node with given id
+        /**
+         * @param id: target node id
+         * @param command: command name followed by its arguments
+         * @return: encoded frame
+        */
+        auto build_request(std::int64_t const id, std::string_view const command) noexcept(false) -> std::string
         {
-            return std::to_string(id) + " " + std::string{message};
-        }
+            auto const argv = utility::string::split_to_words(command);
+            if (argv.empty())
+            {
+                throw std::invalid_argument{"empty command"};
+            }
 
-        /// Builds request string for the node with given id
-        auto static build_target_request(std::int64_t const target, std::string_view const request) -> std::string
-        {
-            return std::string{request} + " " + std::to_string(target);
+            auto frame = network::frame
+            {
+                .request_id = ++last_request_id_,
+                .target_id = id,
+                .code = parse_opcode(argv[0]),
+            };
+            for (auto i = std::size_t{1}; i < argv.size(); ++i)
+            {
+                frame.push(argv[i]);
+            }
+
+            return frame.encode();
         }
 
         /// Removes node from current network
@@ -140,106 +208,158 @@ namespace network::topology::tree
                     node->task.kill();
                     root_nodes_.erase(node);
 
+                    //
+                    // Whole subtree is gone with it
+                    //
+                    std::erase_if(routes_, [id](auto const& route) { return route.second == id; });
+
                     return {.error = error::ok};
                 }
             }
 
-            auto const request = build_target_request(id, "remove");
-            auto const primary = build_request(any_node, request);
-            return ask_every_until_response(any_node, primary);
+            //
+            // Parent of the node is in the subtree which holds it
+            //
+            auto const primary  = build_request(any_node, "remove " + std::to_string(id));
+            auto const response = ask_along(id, any_node, primary);
+            if (response.error == error::ok)
+            {
+                routes_.erase(id);
+            }
+            return response;
         }
 
         /// Sends message once to every root node until valuable response
         /**
-         * @param message: string that will be sent
+         * Message goes down the single subtree known to hold the target node. If there is
+         * no such subtree or the route turns out to be stale, children are asked at once and
+         * the subtree of the first valuable response is remembered.
+         *
+         * @param message: encoded frame that will be sent
          * @param target_id: target node id
          * @return: first valuable response
         */
         auto ask_every_until_response(std::int64_t const target_id, std::string_view const message) -> response
         {
-            auto recv_response = [target_id](zmq::socket_t& socket, std::int64_t const node_id) -> response
-            {
-                auto       response = zmq::message_t{256};
-                auto const result   = socket.recv(response, zmq::recv_flags::none);
-                if (!result.has_value())
-                {
-                    return
-                    {
-                        .error = target_id == node_id ? error::unavailable : error::invalid_path ,
-                    };
-                }
-                response.rebuild(*result);
-
-                auto deserialized_response = network::response{};
-                deserialized_response.deserialize_from(response);
-
-                return deserialized_response;
-            };
+            return ask_along(target_id, target_id, message);
+        }
 
-            /// Low-level sending routine
-            auto static send_request = [&](zmq::socket_t& socket, request const& request, std::int64_t const node_id) -> response
+        /// Routes requests for the node the same way as requests for its parent
+        /**
+         * @param id: id of the node just created in the subtree of the parent
+         * @param parent_id: parent node id
+        */
+        auto route_like(std::int64_t const id, std::int64_t const parent_id) -> void
+        {
+            if (auto const route = routes_.find(parent_id); route != routes_.end())
             {
-                auto serialized_request = zmq::message_t{request.size()};
-                request.serialize_to(serialized_request);
-                socket.send(serialized_request, zmq::send_flags::none);
+                routes_.insert_or_assign(id, route->second);
+            }
+        }
 
-                return recv_response(socket, node_id);
-            };
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t
+        {
+            return root_nodes_.size();
+        }
 
-            /// Sending routine
-            auto send = [this](node const& node, std::string_view const string) -> response
+    private:
+        /// Sends message down the subtree which holds the node, or to every root node
+        /**
+         * @param route_id: id of the node which route is used
+         * @param target_id: target node id, may be any_node
+         * @param message: encoded frame that will be sent
+         * @return: first valuable response
+        */
+        auto ask_along(std::int64_t const route_id, std::int64_t const target_id, std::string_view const message)
+        -> response
+        {
+            //
+            // Try known route first
+            //
+            auto tried          = static_cast<node const*>(nullptr);
+            auto tried_response = std::optional<response>{};
+            if (auto const route = routes_.find(route_id); route != routes_.end())
             {
-                //
-                // Open envelope socket
-                //
-                auto socket = zmq::socket_t{context_, ZMQ_REQ};
-                socket.setsockopt(ZMQ_RCVTIMEO, 1000);
-                socket.connect(node.address);
-
-                //
-                // Send envelope
-                //
-                if (auto response = send_request(socket, {.type = request::type::envelope}, node.id);
-                    response.error != error::ok)
+                auto const child = std::find_if(root_nodes_.begin(), root_nodes_.end(), [&](node const& node)
+                {
+                    return node.id == route->second;
+                });
+                if (child != root_nodes_.end())
                 {
-                    return response;
+                    auto [response, replied] = ask_nodes(target_id, {&*child}, message);
+                    if (replied != nullptr)
+                    {
+                        return response;
+                    }
+                    tried          = &*child;
+                    tried_response = std::move(response);
                 }
 
                 //
-                // Open message socket
+                // Route is stale, it's rebuilt by the search below
                 //
-                socket = zmq::socket_t{context_, ZMQ_REQ};
-                socket.setsockopt(ZMQ_RCVTIMEO, 30000);
-                socket.connect(node.address);
+                routes_.erase(route);
+            }
 
-                //
-                // Send message
-                //
-                auto response = send_request(
-                    socket, 
-                    {
-                        .type = request::type::message,
-                        .message = std::string{string}
-                    }, 
-                    node.id);
+            //
+            // Search every other subtree, the tried one has already answered
+            //
+            auto candidates = std::vector<node*>{};
+            for (auto& node : root_nodes_)
+            {
+                if (&node != tried)
+                {
+                    candidates.push_back(&node);
+                }
+            }
 
+            auto [response, replied] = ask_nodes(target_id, candidates, message);
+            if (replied != nullptr && route_id != any_node && response.error != error::unavailable)
+            {
+                routes_.insert_or_assign(route_id, replied->id);
+            }
+            if (replied == nullptr && tried_response.has_value() && tried_response->error == error::invalid_path)
+            {
                 //
-                // Return response from last connection
+                // Non-valuable answers are merged as if all subtrees were asked at once
                 //
-                return response;
-            };
+                return *tried_response;
+            }
+            return response;
+        }
+
+        /// Sends message once to every given node until valuable response
+        /**
+         * Nodes are asked at once and the first valuable response wins, requests still
+         * waited for are abandoned. Latency is the one of the path to the target node
+         * rather than the sum of searches in every subtree.
+         *
+         * @param target_id: target node id
+         * @param nodes: nodes that will be asked
+         * @param message: encoded frame that will be sent
+         * @return: first valuable response and the node which sent it, or nullptr if there is none
+        */
+        auto ask_nodes(std::int64_t const target_id, std::vector<node*> const& nodes, std::string_view const message)
+        -> std::pair<response, node*>
+        {
+            using namespace std::chrono_literals;
 
             auto non_valuable_response = response
             {
                 .error = error::unknown
             };
+            auto valuable_response = std::optional<response>{};
+            auto replied           = static_cast<node*>(nullptr);
 
-            //
-            // Loop over nearest nodes
-            //
-            for (auto const& node : root_nodes_)
+            /// Sorts out reply of the node, nothing means the node is lost; returns true on valuable one
+            auto judge = [&](node& node, std::optional<response> reply) -> bool
             {
-                auto response = send(node, message);
+                auto response = std::move(reply).value_or(network::response
+                {
+                    .error = target_id == node.id ? error::unavailable : error::invalid_path,
+                });
+
                 if (response.error == error::invalid_path)
                 {
                     non_valuable_response = network::response
@@ -247,27 +367,219 @@ namespace network::topology::tree
                         .error = error::invalid_path,
                     };
 
-                    continue;
+                    return false;
                 }
                 if (response.error != error::unknown)
                 {
-                    return response;
+                    valuable_response = std::move(response);
+                    replied           = &node;
+                    return true;
+                }
+                return false;
+            };
+
+            //
+            // Collect nearest nodes which may reply
+            //
+            auto candidates = std::vector<node*>{};
+            for (auto* node : nodes)
+            {
+                if (protocol_ == protocol::direct && not node->task.running())
+                {
+                    //
+                    // Dead child can't reply, there is no need to wait for the timeout
+                    //
+                    if (judge(*node, std::nullopt))
+                    {
+                        return {*valuable_response, replied};
+                    }
+                    continue;
+                }
+                candidates.push_back(node);
+            }
+
+            if (protocol_ == protocol::handshake)
+            {
+                //
+                // Send envelopes, only nodes which accepted it get the message. Node still busy
+                // with the abandoned request can't answer in time, it's sure to be alive and
+                // gets the message right away
+                //
+                auto accepted = std::vector<node*>{};
+                auto probed   = std::vector<node*>{};
+                for (auto* node : candidates)
+                {
+                    (node->connection.idle() ? probed : accepted).push_back(node);
                 }
+                ask_all(probed, {.type = request::type::envelope}, 1s,
+                    [&](node& node, std::optional<response> reply) -> bool
+                    {
+                        if (reply.has_value() && reply->error == error::ok)
+                        {
+                            accepted.push_back(&node);
+                            return false;
+                        }
+                        return judge(node, std::move(reply));
+                    });
+
+                if (valuable_response.has_value())
+                {
+                    return {*valuable_response, replied};
+                }
+                candidates = std::move(accepted);
+            }
+
+            //
+            // Send message
+            //
+            auto const request_id = frame::decode(message).request_id;
+            ask_all(candidates, {.type = request::type::message, .message = std::string{message}}, 30s,
+                [&](node& node, std::optional<response> reply) -> bool
+                {
+                    //
+                    // Reply to another request is as good as no reply
+                    //
+                    if (reply.has_value() && reply->request_id != request_id)
+                    {
+                        reply.reset();
+                    }
+                    return judge(node, std::move(reply));
+                });
+
+            if (valuable_response.has_value())
+            {
+                return {*valuable_response, replied};
             }
 
             //
             // We didn't get any valuable response
             //
-            return non_valuable_response;
+            return {non_valuable_response, nullptr};
         }
 
-        [[nodiscard]]
-        auto size() const noexcept -> std::size_t
+        /// Sends request to every given node at once and passes replies to the callback as they come
+        /**
+         * @param nodes: nodes that will be asked
+         * @param request: request that will be sent
+         * @param timeout: time to wait for all replies, nodes which didn't reply are passed with nothing
+         * @param on_reply: callable of node& and std::optional<response>; returns true to stop waiting,
+         *                  requests still waited for are abandoned then
+        */
+        template <typename Callback>
+        static auto ask_all(
+            std::vector<node*> const&       nodes,
+            request const&                  request,
+            std::chrono::milliseconds const timeout,
+            Callback&&                      on_reply) -> void
         {
-            return root_nodes_.size();
+            auto waited = std::vector<node*>{};
+            auto items  = std::vector<zmq::pollitem_t>{};
+
+            //
+            // Abandoned requests are left to the nodes, they are busy until reply
+            //
+            auto abandon_waited = [&]() -> void
+            {
+                waited.clear();
+            };
+
+            try
+            {
+                //
+                // Post request everywhere first
+                //
+                for (auto* node : nodes)
+                {
+                    if (node->connection.post(request))
+                    {
+                        waited.push_back(node);
+                    }
+                    else if (on_reply(*node, std::nullopt))
+                    {
+                        abandon_waited();
+                        return;
+                    }
+                }
+
+                //
+                // Take replies in order of arrival
+                //
+                auto const deadline = std::chrono::steady_clock::now() + timeout;
+                while (not waited.empty())
+                {
+                    auto const left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now());
+                    if (left <= std::chrono::milliseconds::zero())
+                    {
+                        break;
+                    }
+
+                    items.clear();
+                    for (auto* node : waited)
+                    {
+                        items.push_back(node->connection.poll_item());
+                    }
+                    if (zmq::poll(items, left) == 0)
+                    {
+                        continue;
+                    }
+
+                    for (auto i = items.size(); i-- > 0;)
+                    {
+                        if ((items[i].revents & ZMQ_POLLIN) == 0)
+                        {
+                            continue;
+                        }
+
+                        auto* const node  = waited[i];
+                        auto        reply = node->connection.take();
+                        if (not reply.has_value() && node->connection.waiting())
+                        {
+                            //
+                            // Late reply to the abandoned request was dropped
+                            //
+                            continue;
+                        }
+                        waited.erase(waited.begin() + static_cast<std::ptrdiff_t>(i));
+
+                        if (on_reply(*node, std::move(reply)))
+                        {
+                            abandon_waited();
+                            return;
+                        }
+                    }
+                }
+
+                //
+                // Nodes which didn't reply in time are lost
+                //
+                auto const lost = std::move(waited);
+                waited.clear();
+                for (auto* node : lost)
+                {
+                    node->connection.reset();
+                }
+                for (auto* node : lost)
+                {
+                    if (on_reply(*node, std::nullopt))
+                    {
+                        return;
+                    }
+                }
+            }
+            catch (...)
+            {
+                //
+                // State of the nodes still waited for is unknown, they start anew
+                //
+                for (auto* node : waited)
+                {
+                    node->connection.reset();
+                }
+                throw;
+            }
         }
 
-    private:
         /// Throws runtime_error with prefix "Internal error: " 
         [[noreturn]]
         static auto throw_internal(std::string_view const message) noexcept(false) -> void
@@ -51,6 +51,10 @@ namespace tasking {
         /// Stop task immediately
         auto kill() -> void;
 
+        /// Check if task is still running
+        [[nodiscard]]
+        auto running() noexcept -> bool;
+
     private:
         /// Copy storage from current task to the other's
         auto copy_to(task& other) const noexcept -> void {
@@ -41,7 +41,15 @@ namespace utility::commandline
         */
         auto execute(std::string_view const command) noexcept(false) -> std::optional<R>
         {
-            auto const argv = string::split_to_words(command);
+            return execute(string::split_to_words(command));
+        }
+
+        /// Execute command already split to words
+        /**
+         * @param argv: command name followed by its arguments
+        */
+        auto execute(argv_t argv) noexcept(false) -> std::optional<R>
+        {
             if (std::size(argv) == 0)
             {
                 return std::nullopt;
@@ -102,6 +102,11 @@ auto executable::interface::declare() noexcept(false) -> void
                 auto const request = build_command_with_target("create", target);
                 auto const primary = request + " " + std::to_string(port);
                 response           = engine_.exec(parent, primary);
+
+                if (response.error == network::error::ok)
+                {
+                    engine_.route_like(target, parent);
+                }
             }
 
             if (response.error != network::error::ok)
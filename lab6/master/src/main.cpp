@@ -9,13 +9,25 @@
 
 #include "interface.hpp"
 
-auto main() -> int try
+auto main(int const argc, char const* argv[]) -> int try
 {
     using namespace std::string_view_literals;
     using namespace utility;
 
+    if (argc > 2)
+    {
+        throw std::invalid_argument{"Usage: master [handshake|direct]"};
+    }
+
+    //
+    // Requests go directly by default, 'handshake' probes every node with an envelope first
+    //
+    auto const protocol = argc == 2
+                              ? network::topology::tree::parse_protocol(argv[1])
+                              : network::topology::tree::protocol::direct;
+
     auto context   = zmq::context_t{1};
-    auto engine    = network::topology::tree::engine{context};
+    auto engine    = network::topology::tree::engine{context, protocol};
     auto interface = executable::interface{engine};
 
     auto static process_reply = [](network::response const& response) -> void
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utility/commandline.hpp>
+#include <network/frame.hpp>
 #include <network/response.hpp>
 #include <network/topology.hpp>
 
@@ -37,6 +38,21 @@ namespace executable
             );
         }
 
+        auto execute(network::frame const& frame) noexcept(false) -> network::response
+        {
+            auto argv = std::vector<std::string_view>{network::to_string(frame.code)};
+            argv.insert(argv.end(), frame.arguments.begin(), frame.arguments.begin() + frame.arguments_count);
+
+            auto const response = runner_.execute(argv);
+
+            return response.value_or(
+                network::response
+                {
+                    .error = network::error::ok
+                }
+            );
+        }
+
         auto kill_requested() const noexcept -> bool
         {
             return killed_;
@@ -5,14 +5,16 @@
 //
 #include <zmq.hpp>
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <sstream>
 
 #include <Windows.h>
 
 #undef interface
 
 #include <utility/commandline.hpp>
+#include <network/frame.hpp>
+#include <network/request.hpp>
 #include <network/response.hpp>
 #include <network/topology.hpp>
 
@@ -22,34 +24,46 @@ auto main(int const argc, char const* argv[]) -> int try
 {
     using namespace utility;
 
-    if (argc != 3)
+    if (argc != 3 && argc != 4)
     {
         throw std::invalid_argument{"Incorrect number of arguments"};
     }
 
-    std::cout
-        << "[#] New node created with the following parameters:" << std::endl
-        << "    path     : " << argv[0] << std::endl
-        << "    address  : " << argv[1] << std::endl
-        << "    id       : " << argv[2] << std::endl;
-
     //
     //  As we start program via CreateProcess it's doesn't receive argv[0] as path to program which started.
     //  Following it argv[0] will be an address, argv[1] will be an unique id. 
+    //  Optional argv[2] is a protocol used to talk to the children, 'handshake' if it's not given.
+    //  Nodes talk by frames of one version, so master and all nodes must be of the same build.
     //
-    auto const* address = argv[1];
-    auto const  id      = std::stoll(argv[2]);
+    auto const* address  = argv[1];
+    auto const  id       = std::stoll(argv[2]);
+    auto const  protocol = argc == 4
+                               ? network::topology::tree::parse_protocol(argv[3])
+                               : network::topology::tree::protocol::handshake;
+
+    std::cout
+        << "[#] New node created with the following parameters:" << std::endl
+        << "    path     : " << argv[0] << std::endl
+        << "    address  : " << argv[1] << std::endl
+        << "    id       : " << argv[2] << std::endl
+        << "    protocol : " << network::topology::tree::to_string(protocol) << std::endl;
 
     //
     //  Prepare our context and socket
     //
     auto context   = zmq::context_t{1};
-    auto engine    = network::topology::tree::engine{context};
+    auto engine    = network::topology::tree::engine{context, protocol};
     auto interface = executable::interface{engine, id};
     auto socket    = zmq::socket_t{context, ZMQ_REP};
     socket.bind(address);
-    auto send_response = [&socket](network::response const& response) -> void
+    auto request_id    = std::uint64_t{0};
+    auto send_response = [&socket, &request_id](network::response response) -> void
     {
+        //
+        // Response is matched to the request by its id
+        //
+        response.request_id = request_id;
+
         auto serialized_response = zmq::message_t{response.size()};
         response.serialize_to(serialized_response);
         socket.send(serialized_response, zmq::send_flags::dontwait);
@@ -62,53 +76,68 @@ auto main(int const argc, char const* argv[]) -> int try
         //
         // Receive request
         //
-        auto       serialized_request = zmq::message_t{256};
-        auto const result             = socket.recv(serialized_request, zmq::recv_flags::none);
-        serialized_request.rebuild(*result);
+        auto serialized_request = zmq::message_t{};
+        if (not socket.recv(serialized_request, zmq::recv_flags::none).has_value())
+        {
+            continue;
+        }
+        request_id = 0;
 
         //
         // Process request
         //
         try
         {
-            auto request = network::request{};
-            request.deserialize_from(serialized_request);
+            //
+            // Request is read right from the received bytes: type byte and encoded frame
+            //
+            auto const bytes = std::string_view{
+                static_cast<char const*>(serialized_request.data()),
+                serialized_request.size()
+            };
+            if (bytes.empty())
+            {
+                throw std::invalid_argument{"empty request"};
+            }
 
             std::cout << std::endl;
-            std::cout << "[^] Request  : [" << request.code_to_string() << "] " << request.message << std::endl;
 
-            if (request.type == network::request::type::envelope)
+            if (bytes.front() == static_cast<char>(network::request::type::envelope))
             {
                 //
                 // Send 'ok' back immediately on envelope request
                 //
+                std::cout << "[^] Request  : [envelope]" << std::endl;
                 send_response({.error = network::error::ok});
                 continue;
             }
 
-            auto request_stream = std::stringstream{request.message};
-            auto target_id      = std::int64_t{};
-            if (not (request_stream >> target_id))
+            //
+            // Id is read first, so even the reply to a malformed frame reaches its sender
+            //
+            request_id       = network::frame::request_id_of(bytes.substr(1));
+            auto const frame = network::frame::decode(bytes.substr(1));
+
+            std::cout << "[^] Request  : [message] #" << frame.request_id << " " << frame.target_id << " "
+                      << network::to_string(frame.code);
+            for (auto i = std::size_t{0}; i < frame.arguments_count; ++i)
             {
-                throw std::invalid_argument{"invalid target id"};
+                std::cout << " " << frame.arguments[i];
             }
+            std::cout << std::endl;
 
             auto response = network::response{};
 
-            if (target_id == id || target_id == network::topology::any_node)
+            if (frame.target_id == id || frame.target_id == network::topology::any_node)
             {
-                auto command = std::string{};
-
-                for (auto line = std::string{}; std::getline(request_stream, line);)
-                {
-                    command += line + "\n";
-                }
-
-                response = interface.execute(command);
+                response = interface.execute(frame);
             }
             else
             {
-                response = engine.ask_every_until_response(target_id, request.message);
+                //
+                // Frame is forwarded as it is
+                //
+                response = engine.ask_every_until_response(frame.target_id, bytes.substr(1));
             }
 
             //
@@ -65,6 +65,14 @@ auto tasking::task::kill() -> void {
     handlers.close_safe();
 }
 
+auto tasking::task::running() noexcept -> bool {
+    //
+    // Killed task has no process handle, zero timeout only polls the state.
+    //
+    auto const h_process = this->as<task_handlers>().h_process;
+    return h_process != nullptr && WaitForSingleObject(h_process, 0) == WAIT_TIMEOUT;
+}
+
 auto tasking::launcher::start() const noexcept(false) -> task {
     auto                task = tasking::task {};
     STARTUPINFOA        info = {sizeof(info)};